@@ -0,0 +1,176 @@
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/OctreeQuantizer.hpp"
+#include "splash/Palette.hpp"
+#include "splash/Simd.hpp"
+#include "splash/WuQuantizer.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Dimensions of the generated image
+#define WIDTH 4096
+#define HEIGHT 2048
+
+// Number of rows the kernel is run over repeatedly (small enough to stay in cache)
+#define CACHED_ROWS 16
+
+// Size of the region used to compare quantizers (small so that counting doesn't dominate)
+#define COMPARE_SIZE 256
+
+// Number of threads used when measuring quantizing on more than one
+#define THREAD_COUNT 4
+
+// Number of colours requested when comparing word widths
+#define WIDTH_COLOURS 16
+
+// Number of colours and k-means iterations used when measuring refinement
+#define REFINE_COLOURS 8
+#define REFINE_ITERATIONS 4
+
+// Number of swatches and custom targets used when measuring target scoring
+#define SCORE_SWATCHES 64
+#define SCORE_TARGETS 48
+
+// Number of times each measurement is repeated (the fastest is reported)
+#define REPEATS 5
+
+// Returns the fastest time (in seconds) taken to run the given function
+template <typename F>
+static double timeFastest(F func) {
+    double best = 0;
+    for (size_t i = 0; i < REPEATS; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double> taken = std::chrono::steady_clock::now() - start;
+        if (i == 0 || taken.count() < best) {
+            best = taken.count();
+        }
+    }
+    return best;
+}
+
+// Prints the rate in millions of pixels per second
+static void printRate(const std::string & name, double seconds) {
+    double rate = (static_cast<double>(WIDTH) * HEIGHT)/seconds/1000000.0;
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1) << std::setw(10) << rate << " Mpixels/s" << std::endl;
+}
+
+// Prints the time taken in milliseconds
+static void printTime(const std::string & name, double seconds) {
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(3) << std::setw(10) << (seconds * 1000.0) << " ms" << std::endl;
+}
+
+int main(void) {
+    // Fill an image with random opaque colours
+    std::vector<uint32_t> pixels(WIDTH * HEIGHT);
+    std::mt19937 rng(1);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = 0xff000000 | (rng() & 0xffffff);
+    }
+    std::vector<uint16_t> indices(WIDTH);
+    Splash::BitmapView view = Splash::BitmapView(pixels.data(), WIDTH, HEIGHT, WIDTH * sizeof(uint32_t), Splash::PixelFormat::ARGB8888);
+    std::vector<Splash::Filter::Filter *> filters;
+
+    std::cout << "Image: " << WIDTH << "x" << HEIGHT << " (fastest of " << REPEATS << " runs)" << std::endl;
+    const Splash::Simd::ISA isas[] = { Splash::Simd::ISA::Scalar, Splash::Simd::ISA::SSE2, Splash::Simd::ISA::AVX2, Splash::Simd::ISA::NEON };
+    for (Splash::Simd::ISA isa : isas) {
+        if (!Splash::Simd::setISA(isa)) {
+            continue;
+        }
+        std::cout << Splash::Simd::toString(isa) << ":" << std::endl;
+
+        // Conversion of pixels to histogram indices only, reading from cache
+        // so that memory bandwidth isn't what's being measured
+        printRate("quantizeRow", timeFastest([&]() {
+            for (size_t y = 0; y < HEIGHT; y++) {
+                Splash::Simd::quantizeRow(pixels.data() + ((y % CACHED_ROWS) * WIDTH), WIDTH, indices.data());
+            }
+        }));
+
+        // Building the histogram and generating the palette from it
+        printRate("quantizer", timeFastest([&]() {
+            Splash::ColourCutQuantizer quantizer = Splash::ColourCutQuantizer(view, 16, filters);
+        }));
+    }
+    Splash::Simd::setISA(Splash::Simd::detectISA());
+
+    // Compare the quantizers as the number of colours grows
+    Splash::BitmapView region = view.crop(0, 0, COMPARE_SIZE, COMPARE_SIZE);
+    std::cout << "Quantizers (" << COMPARE_SIZE << "x" << COMPARE_SIZE << ", time per palette):" << std::endl;
+    const int counts[] = { 16, 64, 256 };
+    for (int count : counts) {
+        printTime("ColourCut " + std::to_string(count), timeFastest([&]() {
+            Splash::ColourCutQuantizer quantizer = Splash::ColourCutQuantizer(region, count, filters);
+        }));
+        printTime("Wu " + std::to_string(count), timeFastest([&]() {
+            Splash::WuQuantizer quantizer = Splash::WuQuantizer(region, count, filters);
+        }));
+        printTime("Octree " + std::to_string(count), timeFastest([&]() {
+            Splash::OctreeQuantizer quantizer = Splash::OctreeQuantizer(count, filters);
+            quantizer.add(region);
+            quantizer.getQuantizedColours();
+        }));
+    }
+
+    // Splitting boxes ahead on other threads (the same threads are reused for every split)
+    std::cout << "Threads (" << COMPARE_SIZE << "x" << COMPARE_SIZE << ", " << THREAD_COUNT << " threads, time per palette):" << std::endl;
+    for (int count : counts) {
+        printTime("ColourCut " + std::to_string(count), timeFastest([&]() {
+            Splash::ColourCutQuantizer quantizer = Splash::ColourCutQuantizer(region, count, filters, THREAD_COUNT);
+        }));
+    }
+
+    // Compare the precision of the histogram (bits kept per component)
+    std::cout << "Word widths (" << COMPARE_SIZE << "x" << COMPARE_SIZE << ", " << WIDTH_COLOURS << " colours, time per palette):" << std::endl;
+    for (int width = Splash::Histogram::MIN_WORD_WIDTH; width <= Splash::Histogram::MAX_WORD_WIDTH; width++) {
+        printTime("ColourCut " + std::to_string(width) + " bit", timeFastest([&]() {
+            Splash::ColourCutQuantizer quantizer = Splash::ColourCutQuantizer(region, WIDTH_COLOURS, filters, 1, nullptr, width);
+        }));
+        printTime("Wu " + std::to_string(width) + " bit", timeFastest([&]() {
+            Splash::WuQuantizer quantizer = Splash::WuQuantizer(region, WIDTH_COLOURS, filters, 1, nullptr, width);
+        }));
+    }
+
+    // Cost of refining the swatches compared to requesting more of them
+    std::cout << "Refinement (" << COMPARE_SIZE << "x" << COMPARE_SIZE << ", time per palette):" << std::endl;
+    printTime("Plain " + std::to_string(REFINE_COLOURS * 2), timeFastest([&]() {
+        Splash::Palette::from(region).clearFilters().resizeBitmapArea(0).setMaximumColourCount(REFINE_COLOURS * 2).generate();
+    }));
+    printTime("Refined " + std::to_string(REFINE_COLOURS), timeFastest([&]() {
+        Splash::Palette::from(region).clearFilters().resizeBitmapArea(0).setMaximumColourCount(REFINE_COLOURS).setRefinement(REFINE_ITERATIONS).generate();
+    }));
+
+    // Generating palettes for several counts at once compared to one at a time
+    const std::vector<size_t> several = { 8, 16, 32 };
+    std::cout << "Several counts (" << COMPARE_SIZE << "x" << COMPARE_SIZE << ", 8, 16 and 32 colours):" << std::endl;
+    printTime("Separately", timeFastest([&]() {
+        for (size_t count : several) {
+            Splash::Palette::from(region).clearFilters().resizeBitmapArea(0).setMaximumColourCount(count).generate();
+        }
+    }));
+    printTime("Together", timeFastest([&]() {
+        Splash::Palette::from(region).clearFilters().resizeBitmapArea(0).generate(several);
+    }));
+
+    // Picking swatches for many custom targets
+    std::vector<Splash::Swatch> swatches;
+    for (size_t i = 0; i < SCORE_SWATCHES; i++) {
+        swatches.push_back(Splash::Swatch(Splash::Colour(rng() & 0xff, rng() & 0xff, rng() & 0xff, 255), 1 + rng() % 1000));
+    }
+    Splash::Palette::Builder scored = Splash::Palette::Builder(swatches);
+    for (size_t i = 0; i < SCORE_TARGETS; i++) {
+        float lightness = static_cast<float>(i)/SCORE_TARGETS;
+        scored.addTarget(Splash::Target::Target::Builder().setMinimumLightness(0).setTargetLightness(lightness).setMaximumLightness(1).setMinimumSaturation(0).setTargetSaturation(1.0f - lightness).setMaximumSaturation(1).setExclusive(i % 2 == 0).build());
+    }
+    std::cout << "Targets (" << SCORE_SWATCHES << " swatches, " << SCORE_TARGETS << " targets):" << std::endl;
+    printTime("Palette", timeFastest([&]() {
+        scored.generate();
+    }));
+
+    return 0;
+}
\ No newline at end of file
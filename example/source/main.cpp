@@ -20,19 +20,21 @@ int main(int argc, char * argv[]) {
     }
 
     // Convert to a Splash::Bitmap which is used for generating Palettes
-    // The initial bitmap is filled opaque white
+    // Each row is converted into a buffer of Splash::Colour and then copied into the bitmap in one go
     Splash::Bitmap bitmap = Splash::Bitmap(rawImage.width(), rawImage.height());
-    for (size_t x = 0; x < rawImage.width(); x++) {
-        for (size_t y = 0; y < rawImage.height(); y++) {
+    std::vector<Splash::Colour> row(rawImage.width());
+    for (size_t y = 0; y < rawImage.height(); y++) {
+        for (size_t x = 0; x < rawImage.width(); x++) {
             // Get pixel from bitmap_image
             rgb_t pixel;
             rawImage.get_pixel(x, y, pixel);
 
-            // Create colour for pixel and set in bitmap
             // Colour constructor takes (alpha, red, green, blue) where all are between 0 and 255 inclusive
-            Splash::Colour colour = Splash::Colour(255, pixel.red, pixel.green, pixel.blue);
-            bitmap.setPixel(colour, x, y);
+            row[x] = Splash::Colour(255, pixel.red, pixel.green, pixel.blue);
         }
+
+        // Parameters: source pixels, source stride (in pixels), first row, number of rows
+        bitmap.importRows(row.data(), row.size(), y, 1);
     }
 
     // Generate a palette using the default settings
@@ -40,19 +42,19 @@ int main(int argc, char * argv[]) {
     // Calling .generate() on the builder returns the generated palette
     // See splash/Palette.hpp or the Android documentation for more builder methods
     Splash::Palette::Builder builder = Splash::Palette::from(bitmap);
-    std::shared_ptr<Splash::Palette> palette = builder.generate();
+    Splash::Palette palette = builder.generate();
 
     // Print each Swatch
     // Sometimes the library will fail to find a fitting swatch and thus will return an 'invalid' swatch
     // It is worth checking if the swatch is marked as valid, otherwise the colour values contained are undefined!
     std::cout << "==== Palette Swatches ====" << std::endl;
-    std::cout << "Light Vibrant: " << (palette->getLightVibrantSwatch().isValid() ? palette->getLightVibrantSwatch().toString() : "No suitable swatch found.") << std::endl;
-    std::cout << "Vibrant:       " << (palette->getVibrantSwatch().isValid() ? palette->getVibrantSwatch().toString() : "No suitable swatch found.") << std::endl;
-    std::cout << "Dark Vibrant:  " << (palette->getDarkVibrantSwatch().isValid() ? palette->getDarkVibrantSwatch().toString() : "No suitable swatch found.") << std::endl;
-    std::cout << "Light Muted:   " << (palette->getLightMutedSwatch().isValid() ? palette->getLightMutedSwatch().toString() : "No suitable swatch found.") << std::endl;
-    std::cout << "Muted:         " << (palette->getMutedSwatch().isValid() ? palette->getMutedSwatch().toString() : "No suitable swatch found.") << std::endl;
-    std::cout << "Dark Muted:    " << (palette->getDarkMutedSwatch().isValid() ? palette->getDarkMutedSwatch().toString() : "No suitable swatch found.") << std::endl;
-    std::cout << "Dominant:      " << (palette->getDominantSwatch().isValid() ? palette->getDominantSwatch().toString() : "No suitable swatch found.") << std::endl;
+    std::cout << "Light Vibrant: " << (palette.getLightVibrantSwatch().isValid() ? palette.getLightVibrantSwatch().toString() : "No suitable swatch found.") << std::endl;
+    std::cout << "Vibrant:       " << (palette.getVibrantSwatch().isValid() ? palette.getVibrantSwatch().toString() : "No suitable swatch found.") << std::endl;
+    std::cout << "Dark Vibrant:  " << (palette.getDarkVibrantSwatch().isValid() ? palette.getDarkVibrantSwatch().toString() : "No suitable swatch found.") << std::endl;
+    std::cout << "Light Muted:   " << (palette.getLightMutedSwatch().isValid() ? palette.getLightMutedSwatch().toString() : "No suitable swatch found.") << std::endl;
+    std::cout << "Muted:         " << (palette.getMutedSwatch().isValid() ? palette.getMutedSwatch().toString() : "No suitable swatch found.") << std::endl;
+    std::cout << "Dark Muted:    " << (palette.getDarkMutedSwatch().isValid() ? palette.getDarkMutedSwatch().toString() : "No suitable swatch found.") << std::endl;
+    std::cout << "Dominant:      " << (palette.getDominantSwatch().isValid() ? palette.getDominantSwatch().toString() : "No suitable swatch found.") << std::endl;
     std::cout << std::endl;
 
     // Create the MediaStyle object to extract suitable colours for a background and text
@@ -67,4 +69,4 @@ int main(int argc, char * argv[]) {
     std::cout << "Secondary Text Colour: " << style.getSecondaryTextColour().toString() << std::endl;
 
     return 0;
-}
+}
\ No newline at end of file
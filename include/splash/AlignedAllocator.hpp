@@ -0,0 +1,55 @@
+#ifndef SPLASH_ALIGNEDALLOCATOR_HPP
+#define SPLASH_ALIGNEDALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace Splash {
+    // Minimal allocator which returns memory aligned to the given boundary
+    // (in bytes). Used for pixel buffers so that rows can be read using
+    // aligned vector loads.
+    template <typename T, size_t Alignment = 64>
+    class AlignedAllocator {
+        public:
+            typedef T value_type;
+
+            template <typename U>
+            struct rebind {
+                typedef AlignedAllocator<U, Alignment> other;
+            };
+
+            AlignedAllocator() { }
+
+            template <typename U>
+            AlignedAllocator(const AlignedAllocator<U, Alignment> &) { }
+
+            // Over-allocates and stores the original pointer just before the
+            // aligned block so it can be recovered when deallocating
+            T * allocate(size_t n) {
+                void * raw = ::operator new(n * sizeof(T) + Alignment + sizeof(void *));
+                uintptr_t start = reinterpret_cast<uintptr_t>(raw) + sizeof(void *);
+                uintptr_t aligned = (start + Alignment - 1) & ~(static_cast<uintptr_t>(Alignment) - 1);
+                reinterpret_cast<void **>(aligned)[-1] = raw;
+                return reinterpret_cast<T *>(aligned);
+            }
+
+            void deallocate(T * ptr, size_t) {
+                if (ptr != nullptr) {
+                    ::operator delete(reinterpret_cast<void **>(ptr)[-1]);
+                }
+            }
+    };
+
+    template <typename T, typename U, size_t Alignment>
+    bool operator==(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) {
+        return true;
+    }
+
+    template <typename T, typename U, size_t Alignment>
+    bool operator!=(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) {
+        return false;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef SPLASH_AREASCALER_HPP
+#define SPLASH_AREASCALER_HPP
+
+#include "splash/BitmapView.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Splash {
+    // Scales the pixels in a view one row at a time, where each new pixel is the average
+    // of the area of source pixels it covers (or the nearest pixel when scaling up).
+    // Only a single row of intermediate sums is kept, so rows (or parts of rows) of the
+    // scaled image can be produced without ever allocating the whole scaled image.
+    class AreaScaler {
+        private:
+            // Pixels being scaled
+            BitmapView source;
+
+            // Dimensions of the scaled image
+            size_t height;
+            size_t width;
+
+            // Whether to average in linear light
+            bool linear;
+
+            // First source column covered by each scaled column (plus one marking the end)
+            std::vector<size_t> columns;
+
+            // Source row converted to Colours (only used if the source isn't ARGB8888)
+            std::vector<Colour> converted;
+
+            // Per-column sums of each component over the source rows of a scaled row
+            std::vector<uint32_t> acc;
+
+        public:
+            // Constructs a scaler with nothing to scale (see reset())
+            AreaScaler();
+
+            // Constructor takes the view to scale, the scaled width and height and
+            // whether to average in linear light
+            AreaScaler(const BitmapView &, size_t, size_t, bool);
+
+            // Start scaling another view, taking the same parameters as the constructor
+            // Buffers are reused, so nothing is allocated if they're already large enough
+            void reset(const BitmapView &, size_t, size_t, bool);
+
+            // Produce part of a row of the scaled image
+            // Parameters: scaled row, first scaled column, number of columns, destination
+            void scaleRow(size_t, size_t, size_t, Colour *);
+    };
+};
+
+#endif
\ No newline at end of file
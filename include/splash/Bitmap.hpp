@@ -1,25 +1,35 @@
 #ifndef SPLASH_BITMAP_HPP
 #define SPLASH_BITMAP_HPP
 
+#include "splash/AlignedAllocator.hpp"
 #include "splash/Colour.hpp"
 #include <cstddef>
 #include <vector>
 
 namespace Splash {
-    // A bitmap in this context is essentially a 2D array (using vectors)
-    // of Colour objects which represents the pixels of an image
+    // A bitmap in this context is essentially a 2D array of Colour objects
+    // which represents the pixels of an image. Pixels are stored in a single
+    // contiguous row-major buffer, where each row is padded out to the stride
+    // so that every row begins on an aligned boundary.
     class Bitmap {
         private:
             // Is this bitmap valid
             bool valid;
 
-            // Actual 2D vector forming grid
-            std::vector< std::vector<Colour> > grid;
+            // Contiguous pixel buffer (row y starts at index y * stride)
+            std::vector< Colour, AlignedAllocator<Colour> > pixels;
 
             // Dimensions
             size_t height;
             size_t width;
 
+            // Number of pixels between the start of each row (>= width)
+            size_t stride;
+
+            // Reallocate the buffer to the given dimensions, keeping any overlapping
+            // pixels and filling new ones with white
+            void resize(size_t, size_t);
+
         public:
             // Instantiate an invalid bitmap (cannot change to valid even by changing dimensions)
             Bitmap();
@@ -48,6 +58,26 @@ namespace Splash {
             // Returns number of pixels used from source
             size_t setPixels(std::vector<Colour> &, size_t, size_t, size_t, size_t);
 
+            // Copy whole rows from the given buffer into the bitmap
+            // Parameters: source, source stride (in pixels), first row, number of rows
+            // Rows past the bottom of the bitmap are ignored
+            // Returns number of rows copied
+            size_t importRows(const Colour *, size_t, size_t, size_t);
+
+            // Copy whole rows from the bitmap into the given buffer
+            // Parameters: destination, destination stride (in pixels), first row, number of rows
+            // Rows past the bottom of the bitmap are ignored
+            // Returns number of rows copied
+            size_t exportRows(Colour *, size_t, size_t, size_t) const;
+
+            // Return a pointer to the first pixel in the bitmap
+            // Row y begins at data() + (y * getStride())
+            Colour * data();
+            const Colour * data() const;
+
+            // Return the number of pixels between the start of each row
+            size_t getStride() const;
+
             // Return width/height of bitmap
             size_t getHeight() const;
             size_t getWidth() const;
@@ -57,9 +87,9 @@ namespace Splash {
             void setHeight(size_t);
             void setWidth(size_t);
 
-            // Return a scaled version of this bitmap using nearest neighbour interpolation
-            // Given desired width and height
-            Bitmap createScaledBitmap(size_t, size_t) const;
+            // Return a scaled version of this bitmap using area averaging
+            // See BitmapView::createScaledBitmap() for details
+            Bitmap createScaledBitmap(size_t, size_t, bool = false) const;
     };
 };
 
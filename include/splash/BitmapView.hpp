@@ -0,0 +1,79 @@
+#ifndef SPLASH_BITMAPVIEW_HPP
+#define SPLASH_BITMAPVIEW_HPP
+
+#include "splash/Bitmap.hpp"
+#include "splash/PixelFormat.hpp"
+
+namespace Splash {
+    // A BitmapView is a lightweight, non-owning reference to pixels stored elsewhere
+    // (either in a Bitmap or a buffer owned by the caller). No pixels are copied when
+    // creating, copying or cropping a view, so the underlying memory must outlive it.
+    // The pixels may be stored in any supported PixelFormat, which is read directly
+    // when generating palettes.
+    class BitmapView {
+        private:
+            // Pointer to the first pixel (stored as bytes so the stride can be applied)
+            const unsigned char * pixels;
+
+            // Dimensions
+            size_t height;
+            size_t width;
+
+            // Number of bytes between the start of each row
+            size_t stride;
+
+            // Format of the pixels
+            PixelFormat format;
+
+        public:
+            // Instantiate an invalid view which refers to no pixels
+            BitmapView();
+
+            // Create a view over a caller-provided buffer of Colours (PixelFormat::ARGB8888)
+            // Parameters: first pixel, width, height, stride (in pixels, as with Bitmap)
+            BitmapView(const Colour *, size_t, size_t, size_t);
+
+            // Create a view over a caller-provided buffer in the given format
+            // Parameters: first pixel, width, height, stride (in bytes, as rows of some formats
+            // aren't a whole number of pixels), format
+            BitmapView(const void *, size_t, size_t, size_t, PixelFormat);
+
+            // Create a view over an entire Bitmap
+            // Implicit so a Bitmap can be passed anywhere a view is accepted
+            BitmapView(const Bitmap &);
+
+            // Return if the view refers to any pixels
+            bool isValid() const;
+
+            // Return a pointer to the first pixel of the given row
+            // (the pixels are stored in the view's format)
+            const void * getRow(size_t) const;
+
+            // Return an individual pixel in the view
+            // Returns white with alpha 255 if outside of boundaries
+            Colour getPixel(size_t, size_t) const;
+
+            // Return a view of the given region of this view (no pixels are copied)
+            // The region is clipped to the view's boundaries
+            // Parameters: left x, top y, width, height
+            BitmapView crop(size_t, size_t, size_t, size_t) const;
+
+            // Return width/height of view
+            size_t getHeight() const;
+            size_t getWidth() const;
+
+            // Return the number of bytes between the start of each row (Bitmap::getStride() is in pixels)
+            size_t getStride() const;
+
+            // Return the format of the viewed pixels
+            PixelFormat getFormat() const;
+
+            // Return a scaled copy of the viewed pixels. Each new pixel is the average of the
+            // area of pixels it covers (or the nearest pixel when scaling up).
+            // Parameters: desired width, desired height, whether to average in linear light
+            // (more accurate but slower) instead of directly on the sRGB values
+            Bitmap createScaledBitmap(size_t, size_t, bool = false) const;
+    };
+};
+
+#endif
\ No newline at end of file
@@ -1,12 +1,18 @@
 #ifndef SPLASH_COLOURCUTQUANTIZER_HPP
 #define SPLASH_COLOURCUTQUANTIZER_HPP
 
+#include "splash/BitmapView.hpp"
 #include "splash/filter/Filter.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Histogram.hpp"
 #include "splash/Swatch.hpp"
-#include <queue>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace Splash {
+    class QuantizerWorkspace;
+
     // Dimension/component of RGB int to operate on
     enum class Dimension {
         Red,
@@ -21,49 +27,37 @@ namespace Splash {
     // number of colours.
     class ColourCutQuantizer {
         private:
-            // Represents a tightly fitting box around a colour space
-            class Vbox {
-                private:
-                    // Reference to ColourCutQuantizer that this Vbox is a member of
-                    // (needed so it can access members)
-                    ColourCutQuantizer * ccq;
-
-                    // Lower and upper indexes are inclusive
-                    size_t lowerIndex;
-                    size_t upperIndex;
+            // The workspace stores Vboxes, and the split tree records how they're split
+            friend class QuantizerWorkspace;
+            friend class SplitTree;
 
-                    // Population (number) of colours within this box
-                    int population;
-
-                    // Min and max values
-                    int minR, minG, minB;
-                    int maxR, maxG, maxB;
+            // Represents a tightly fitting box around a colour space. Boxes are kept in a heap,
+            // so they're stored as compact 16 byte records which refer to a range of colours.
+            class Vbox {
+                public:
+                    // Lower and upper indexes (into colours) are inclusive
+                    uint32_t lowerIndex;
+                    uint32_t upperIndex;
 
-                    // Recompute box boundaries to tightly fit the colours within the box
-                    void fitBox();
+                    // Min and max quantized values
+                    uint8_t minR, minG, minB;
+                    uint8_t maxR, maxG, maxB;
 
-                public:
-                    // Constructor takes lower and upper indexes and fits the box
-                    // Unlike the Java version it also takes a pointer to the ColourCutQuantizer object
-                    // it is a part of
-                    Vbox(ColourCutQuantizer *, size_t, size_t);
+                    // Constructor takes lower and upper indexes, with the bounds left empty
+                    // (the first colour included will set them)
+                    Vbox(size_t, size_t);
 
-                    // Split this box at the midpoint along it's longest dimension
-                    Vbox splitBox();
+                    // Expand the bounds to include the given colour (with W bits per component)
+                    template <int W>
+                    void include(int);
 
                     // Return the dimension which this box is largest in
                     Dimension getLongestColourDimension() const;
 
-                    // Finds the point within the box's indexes of where to split
-                    // Returns the index in the CCQ's colours vector to split from
-                    size_t findSplitPoint();
-
-                    // Returns the average colour of this box
-                    Swatch getAverageColour() const;
-
-                    // Modify the significant octet in a colour. Allows sorting based on the
-                    // value of a single colour component
-                    static void modifySignificantOctet(std::vector<int> &, Dimension, size_t, size_t);
+                    // Returns the colour with its components reordered so the given dimension is the
+                    // most significant. Boxes are split in the order of this key.
+                    template <int W>
+                    static int splitKey(int, Dimension);
 
                     // Return characteristics of box
                     int getVolume() const;
@@ -71,52 +65,118 @@ namespace Splash {
                     int getColourCount() const;
             };
 
+            // A box which has been split ahead of being taken from the heap, and its two halves
+            struct Split {
+                Vbox box;
+                Vbox lower;
+                Vbox upper;
+            };
+
             // Comparator for Vboxes
-            static bool VBOX_COMP(Vbox &, Vbox &);
+            static bool VBOX_COMP(const Vbox &, const Vbox &);
 
-            // Vector of colours (i.e. pixels) stored as raw integers
-            std::vector<int> colours;
-            // Histogram of quantized colour frequency
-            std::vector<int> histogram;
+            // Workspace providing scratch memory (only used during construction)
+            QuantizerWorkspace & workspace;
+            // Vector of distinct quantized colours (histogram indices), held in the workspace
+            std::vector<uint32_t> & colours;
+            // Histogram of quantized colour frequency, held in the workspace
+            std::vector<int64_t> & histogram;
 
             // Pointers to passed filters (not deleted!)
             std::vector<Filter::Filter *> filters;
+            // Colours allowed by the filters
+            std::shared_ptr<const Filter::FilterMask> mask;
+            // Number of threads which may be used to split boxes
+            size_t threads;
             // Quantized colours stored as Swatches
             std::vector<Swatch> quantizedColours;
 
+            // Filters the counted histogram and reduces it to the given number of colours,
+            // then clears the used parts of the workspace
+            void quantizeHistogram(int);
+
+            // Reduces the filtered colours to the given number of colours
+            void reduceColours(int);
+
+            // The methods below are templated on the word width (W bits per component)
+            // so that the masks and shifts are constants
+
+            // Reduces the filtered colours to the given number of colours
+            template <int W>
+            std::vector<Swatch> quantizeColours(int);
+
             // Quantizes stored pixels to given number of colours
+            template <int W>
             std::vector<Swatch> quantizePixels(int);
 
-            // Iterate through the given priority queue and split Vboxes until
-            // the queue contains the given number of Vboxes
-            void splitBoxes(std::priority_queue<Vbox, std::vector<Vbox>, decltype(&VBOX_COMP)> &, int);
+            // Recompute the box's bounds to tightly fit the colours within it
+            template <int W>
+            void fitBox(Vbox &) const;
 
-            // Return the average colours in the given vector of Vboxes
-            std::vector<Swatch> generateAverageColours(std::vector<Vbox> &);
+            // Split the box at the midpoint of its population along its longest dimension,
+            // returning the upper half (the given box becomes the lower half)
+            template <int W>
+            Vbox splitBox(Vbox &);
+
+            // Iterate through the given heap and split Vboxes until the heap contains
+            // the given number of Vboxes, optionally appending each split made to the given vector
+            template <int W>
+            void splitBoxes(std::vector<Vbox> &, int, std::vector<Split> * = nullptr);
 
-            // Returns if the colour should be ignored
-            bool shouldIgnoreColour565(int);
-            bool shouldIgnoreColour888(int);
+            // Split the given box along with the largest others in the heap which are likely to be
+            // split soon, spread across threads, storing the results in the workspace's splits.
+            // Boxes cover separate ranges of colours so they can be split at the same time.
+            template <int W>
+            void splitAhead(const Vbox &, const std::vector<Vbox> &, int);
 
-            // Quantize an RGB888 value
-            static int quantizeFromRGB888(int);
+            // Return the average colour of the box
+            template <int W>
+            Swatch getAverageColour(const Vbox &) const;
 
-            // Convert RGB565 values to RGB888
+            // Return the average colours of the Vboxes in the given heap (emptying it)
+            template <int W>
+            std::vector<Swatch> generateAverageColours(std::vector<Vbox> &);
+
+            // Convert quantized (RGB555 by default) values to RGB888
+            template <int W>
             static int approximateToRGB888(int, int, int);
+            template <int W>
             static int approximateToRGB888(int);
 
             // Modify the word with used for the given dimension
             static int modifyWordWidth(int, int, int);
 
+            // Constructor takes a workspace which has already been counted and filtered with the given
+            // mask, and the number of threads used to split boxes, but doesn't quantize it (used by SplitTree)
+            ColourCutQuantizer(QuantizerWorkspace &, const std::shared_ptr<const Filter::FilterMask> &, size_t);
+
         public:
             // Constructor takes pixels (vector of colours), maximum number of colours in resulting
             // palette and a vector of filters to use for quantization
             ColourCutQuantizer(std::vector<Colour> &, int, std::vector<Filter::Filter *> &);
 
+            // Constructor takes a view of the pixels to quantize (read in place without being copied),
+            // followed by the same parameters as above, and optionally the number of threads to use
+            // when counting colours and splitting boxes (the result is the same no matter how many are used), the
+            // workspace to use (nullptr uses the calling thread's workspace) and the number of bits
+            // kept from each component (between Histogram::MIN_WORD_WIDTH and MAX_WORD_WIDTH)
+            ColourCutQuantizer(const BitmapView &, int, std::vector<Filter::Filter *> &, size_t = 1, QuantizerWorkspace * = nullptr, int = Histogram::WORD_WIDTH);
+
+            // Constructor takes a view of the pixels to quantize, and a width and height to scale the
+            // pixels to before quantizing, followed by the same parameters as above.
+            // Scaling is streamed into the histogram a row at a time, so no scaled copy is created.
+            ColourCutQuantizer(const BitmapView &, size_t, size_t, int, std::vector<Filter::Filter *> &, size_t = 1, QuantizerWorkspace * = nullptr, int = Histogram::WORD_WIDTH);
+
+            // Constructor takes a workspace which has already been counted and filtered with the given
+            // mask (see Histogram::filter()), the maximum number of colours in the resulting palette and
+            // optionally the number of threads used to split boxes. The workspace isn't cleared afterwards.
+            ColourCutQuantizer(QuantizerWorkspace &, int, const std::shared_ptr<const Filter::FilterMask> &, size_t = 1);
+
             // Returns vector of quantized colours as Swatches
             std::vector<Swatch> getQuantizedColours();
 
-            // Quantize the given component (given RGB565 int)
+            // Quantize the given component (given RGB555 int, or W bits per component)
+            template <int W = Histogram::WORD_WIDTH>
             static int quantizedComponent(int, Dimension);
     };
 };
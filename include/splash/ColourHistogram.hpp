@@ -0,0 +1,72 @@
+#ifndef SPLASH_COLOURHISTOGRAM_HPP
+#define SPLASH_COLOURHISTOGRAM_HPP
+
+#include "splash/BitmapView.hpp"
+#include "splash/Histogram.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Splash {
+    class QuantizerWorkspace;
+
+    // Counts of how often each quantized colour occurs in one or more images, which can be
+    // kept after the pixels are gone. Histograms can be combined (e.g. each track's art into
+    // an album's) and stored as a compact blob, and a Palette can be generated straight from
+    // one (see Palette::from()), skipping the pixels entirely.
+    // Only the colours which occur are stored, in ascending order of their histogram index.
+    class ColourHistogram {
+        private:
+            // Number of bits kept from each component
+            int wordWidth;
+            // Occupied bins (ascending) and the number of pixels in each
+            std::vector<uint32_t> bins;
+            std::vector<int64_t> counts;
+
+        public:
+            // Constructs an empty histogram using the given word width
+            explicit ColourHistogram(int = Histogram::WORD_WIDTH);
+
+            // Constructs a histogram by counting the pixels in the view
+            // Parameters: pixels, number of threads to count on, word width
+            explicit ColourHistogram(const BitmapView &, size_t = 1, int = Histogram::WORD_WIDTH);
+
+            // Returns the number of bits kept from each component
+            int getWordWidth() const;
+
+            // Returns the number of distinct (quantized) colours
+            size_t size() const;
+
+            // Returns whether no pixels have been counted
+            bool empty() const;
+
+            // Returns the total number of pixels counted
+            int64_t getPopulation() const;
+
+            // Returns the number of pixels counted with the same quantized colour as the given one
+            int64_t getCount(const Colour &) const;
+
+            // Adds the counts of another histogram to this one
+            // Returns false and does nothing if the word widths differ
+            bool merge(const ColourHistogram &);
+
+            // Removes the counts of another histogram from this one (no count goes below zero)
+            // Returns false and does nothing if the word widths differ
+            bool subtract(const ColourHistogram &);
+
+            // Returns the histogram stored as a compact blob of bytes, which is the same on any platform
+            std::vector<uint8_t> serialize() const;
+
+            // Replaces the histogram with one stored using serialize()
+            // Returns false and leaves an empty histogram if the blob isn't valid
+            bool deserialize(const std::vector<uint8_t> &);
+
+            // Adds the counts to the workspace's histogram as Histogram::count() does, after setting its
+            // word width to match. Bins are 64-bit like the counts, so every population is kept exactly.
+            void addTo(QuantizerWorkspace &) const;
+
+            // Returns whether two histograms hold the same counts
+            bool operator==(const ColourHistogram &) const;
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef SPLASH_HISTOGRAM_HPP
+#define SPLASH_HISTOGRAM_HPP
+
+#include "splash/BitmapView.hpp"
+#include <vector>
+
+// Functions shared by the quantizers to count how often each quantized colour occurs.
+// Colours are quantized by keeping the top WORD_WIDTH bits of each of red, green and
+// blue, giving an index of the form RRRRRGGGGGBBBBB into the histogram. Other widths
+// (between MIN_WORD_WIDTH and MAX_WORD_WIDTH) are supported, chosen by the workspace.
+namespace Splash {
+    class QuantizerWorkspace;
+
+    namespace Filter {
+        class FilterMask;
+    };
+};
+
+namespace Splash::Histogram {
+    // Number of bits kept from each component by default
+    const int WORD_WIDTH = 5;
+
+    // Range of supported word widths
+    const int MIN_WORD_WIDTH = 4;
+    const int MAX_WORD_WIDTH = 6;
+
+    // Masks, shifts and sizes used when keeping W bits of each component
+    template <int W>
+    struct Precision {
+        static_assert(W >= MIN_WORD_WIDTH && W <= MAX_WORD_WIDTH, "Unsupported word width");
+
+        // Mask of a quantized component, and the shift from an 8-bit one
+        static constexpr int mask = (1 << W) - 1;
+        static constexpr int shift = 8 - W;
+
+        // Number of bins in a histogram, and 64-bit words in its occupancy bitset
+        static constexpr size_t size = static_cast<size_t>(1) << (W * 3);
+        static constexpr size_t words = size/64;
+
+        // Returns the histogram index of the given 8-bit components
+        static constexpr int quantize(int r, int g, int b) {
+            return ((r >> shift) << (W + W)) | ((g >> shift) << W) | (b >> shift);
+        }
+
+        // Returns a component of the given histogram index (0 = red, 1 = green, 2 = blue)
+        static constexpr int component(int c, int i) {
+            return (c >> (W * (2 - i))) & mask;
+        }
+    };
+
+    // Number of bins in a histogram
+    const size_t SIZE = Precision<WORD_WIDTH>::size;
+
+    // Number of 64-bit words in an occupancy bitset (one bit per bin)
+    const size_t WORDS = SIZE/64;
+
+    // Returns the number of bins in a histogram for the given word width
+    size_t size(int);
+
+    // Largest number of pixels which is counted using 16-bit bins (no bin can overflow)
+    const size_t MAX_COMPACT_PIXELS = 0xffff;
+
+    // Returns the histogram index of the given colour, optionally for another word width
+    int quantize(const Colour &, int = WORD_WIDTH);
+
+    // Returns the (opaque) colour represented by the given histogram index, optionally for another word width
+    Colour colour(int, int = WORD_WIDTH);
+
+    // Counts the occurrences of each quantized colour in the view, reading each row in place
+    // Colours are quantized using the workspace's word width. The counts are added to the workspace's histogram, and the bit of each bin which is
+    // non-zero is set in the workspace's occupancy bitset. Views with at most MAX_COMPACT_PIXELS
+    // pixels are counted into the workspace's smaller 16-bit histogram first.
+    // Parameters: pixels, number of threads to count on (the result is the same no matter how many), workspace
+    void count(const BitmapView &, size_t, QuantizerWorkspace &);
+
+    // Counts the occurrences of each quantized colour in the view after scaling it to the given
+    // size. Each scaled row is counted as soon as it's produced, so no scaled copy is created.
+    // The counts are added to the workspace's histogram as above
+    // Parameters: pixels, width, height, number of threads to count on, workspace
+    void countScaled(const BitmapView &, size_t, size_t, size_t, QuantizerWorkspace &);
+
+    // As above, but returns a newly allocated histogram (using the default word width)
+    std::vector<int64_t> count(const BitmapView &, size_t);
+    std::vector<int64_t> countScaled(const BitmapView &, size_t, size_t, size_t);
+
+    // Zeroes the counted bins which the mask doesn't allow, then lists the remaining
+    // occupied bins in ascending order in the workspace's colours
+    // Only the occupancy bitset is scanned, not the histogram
+    void filter(QuantizerWorkspace &, const Filter::FilterMask &);
+
+    // Zeroes the bins listed in the workspace's colours (along with their occupancy) and
+    // empties the list, leaving the workspace ready to count again
+    void clear(QuantizerWorkspace &);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef SPLASH_KMEANS_HPP
+#define SPLASH_KMEANS_HPP
+
+#include "splash/Swatch.hpp"
+#include <vector>
+
+// Refines the swatches found by a quantizer with a few iterations of k-means, run over
+// the occupied bins of the histogram (weighted by their population). Distances are
+// measured in LAB, which matches how different colours look more closely than RGB, so
+// fewer colours are needed to pick out the distinct ones.
+namespace Splash {
+    class QuantizerWorkspace;
+
+    namespace Filter {
+        class FilterMask;
+    };
+};
+
+namespace Splash::KMeans {
+    // Returns the LAB value of each bin of a histogram with the given word width, stored as
+    // four floats per bin (the last is unused). Each table is built the first time it's needed.
+    const std::vector<float> & labTable(int);
+
+    // Moves each swatch to the centre of the colours nearest to it, repeating until nothing
+    // moves, the given number of iterations have run or the time budget (in milliseconds,
+    // 0 for no limit) is used up. The workspace must have been counted and filtered (see
+    // Histogram::filter()), and isn't cleared afterwards.
+    // Swatches which end up empty, or whose colour isn't allowed by the mask, are dropped.
+    // Parameters: workspace, swatches to refine, mask, maximum iterations, time budget
+    std::vector<Swatch> refine(QuantizerWorkspace &, const std::vector<Swatch> &, const Filter::FilterMask &, int, double);
+};
+
+#endif
\ No newline at end of file
@@ -7,9 +7,6 @@ namespace Splash {
     // Uses the Palette API to generate appropriate colours to show for an album cover
     class MediaStyle {
         private:
-            // Copy of image to use
-            Bitmap image;
-
             // Generated colours
             bool emptyHSL;
             HSL filteredBackgroundHSL;
@@ -20,30 +17,31 @@ namespace Splash {
             // Select colours
             void ensureColours(Colour &, Colour &);
             // Generate the palette to extract colours from
-            void generatePalette();
+            void generatePalette(const BitmapView &);
 
-            // Find and return a fitting background colour
-            Colour findBackgroundColour();
+            // Find and return a fitting background colour using the unfiltered palette
+            Colour findBackgroundColour(const Palette &);
 
             // Returns whether the given swatch makes up enough of the image
-            static bool hasEnoughPopulation(Swatch &);
+            static bool hasEnoughPopulation(const Swatch &);
             // Returns whether the provided colour is light
             static bool isColourLight(Colour &);
 
             // Choose a foreground colour using the background colour and palette
-            Colour selectForegroundColour(Colour &, std::shared_ptr<Palette>);
+            Colour selectForegroundColour(Colour &, const Palette &);
             // Choose a background colour using the provided swatches
             // Returns the provided colour if no swatch matches
-            Colour selectForegroundColourForSwatches(Swatch, Swatch, Swatch, Swatch, Swatch, Colour &);
+            Colour selectForegroundColourForSwatches(const Swatch &, const Swatch &, const Swatch &, const Swatch &, const Swatch &, Colour &);
 
             // Return a Swatch that qualifies as muted (may not be valid!)
-            Swatch selectMutedCandidate(Swatch &, Swatch &);
+            const Swatch & selectMutedCandidate(const Swatch &, const Swatch &);
             // Return a Swatch that qualifies as vibrant (may not be valid!)
-            Swatch selectVibrantCandidate(Swatch &, Swatch &);
+            const Swatch & selectVibrantCandidate(const Swatch &, const Swatch &);
 
         public:
             // Constructor generates palette (may want to use another thread)
-            MediaStyle(Bitmap &);
+            // Accepts a Bitmap or a view of caller-owned pixels (which aren't copied)
+            MediaStyle(const BitmapView &);
 
             // Returns derived colours
             Colour getBackgroundColour();
@@ -0,0 +1,100 @@
+#ifndef SPLASH_OCTREEQUANTIZER_HPP
+#define SPLASH_OCTREEQUANTIZER_HPP
+
+#include "splash/BitmapView.hpp"
+#include "splash/filter/Filter.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Swatch.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Splash {
+    // Colour quantizer based on an octree, which pixels are added to as they arrive (e.g. a
+    // scanline at a time from a decoder) rather than being counted into a histogram first.
+    // Each level of the tree splits the colour cube in eight using the next bit of each
+    // component. The tree is kept within a fixed number of nodes, all allocated up front:
+    // whenever it runs out, the least common deepest branch is merged into a single leaf.
+    // Once every pixel has been added, branches are merged until the requested number of
+    // colours remain.
+    class OctreeQuantizer {
+        private:
+            // Index used for a child which doesn't exist (the root is never a child)
+            static const uint32_t NONE = 0;
+
+            // Node of the tree. Leaves hold the sums of the colours within them, while other
+            // nodes are linked into a list of the branches on their level.
+            struct Node {
+                uint64_t red;
+                uint64_t green;
+                uint64_t blue;
+                uint64_t count;
+                uint32_t children[8];
+                uint32_t next;
+                uint8_t level;
+                bool leaf;
+            };
+
+            // Pool of nodes (the root is always the first)
+            std::vector<Node> nodes;
+            // First unused node in the pool (unused nodes are linked through next)
+            uint32_t freeNodes;
+            // Number of nodes in use
+            size_t used;
+            // First branch on each level
+            std::vector<uint32_t> branches;
+            // Level at which new nodes are made leaves
+            int leafLevel;
+            // Number of leaves in the tree
+            size_t leaves;
+
+            // Last colour added and the leaf it went into, as neighbouring pixels are often the same
+            uint32_t lastColour;
+            uint32_t lastLeaf;
+
+            // Maximum number of colours to return
+            int maxColours;
+            // Colours allowed by the filters
+            std::shared_ptr<const Filter::FilterMask> mask;
+
+            // Takes a node from the pool, returning its index
+            uint32_t allocate(int);
+
+            // Merge the least common branch on the deepest level into a leaf
+            void reduce();
+
+            // Adds the given number of the colour (given as 0xRRGGBB) to the leaf it belongs in
+            void add(uint32_t, uint64_t);
+
+            // Adds every pixel in the view, reading the pixels in the given format
+            template <PixelFormat F>
+            void addPixels(const BitmapView &);
+
+        public:
+            // Default number of nodes in the pool (around 72KB)
+            static const size_t DEFAULT_MAX_NODES = 1024;
+
+            // Constructor takes the maximum number of colours in the resulting palette, a vector of
+            // filters to use and the number of nodes the tree may use (at least 64), which sets
+            // how much memory is used. Filters are checked using the quantized colour of each pixel.
+            OctreeQuantizer(int, std::vector<Filter::Filter *> &, size_t = DEFAULT_MAX_NODES);
+
+            // Same as above, but takes a mask of allowed colours (at any word width) in place of filters
+            OctreeQuantizer(int, const std::shared_ptr<const Filter::FilterMask> &, size_t = DEFAULT_MAX_NODES);
+
+            // Adds each pixel in the view (of any size, so a single row can be passed)
+            void add(const BitmapView &);
+
+            // Adds the given number of pixels of a single colour
+            void add(const Colour &, int64_t);
+
+            // Returns the number of nodes in use
+            size_t getNodeCount() const;
+
+            // Merges the tree down to the maximum number of colours and returns them as Swatches
+            // Pixels can still be added afterwards, but the colours stay merged.
+            std::vector<Swatch> getQuantizedColours();
+    };
+};
+
+#endif
\ No newline at end of file
@@ -1,118 +1,122 @@
 #ifndef SPLASH_PALETTE_HPP
 #define SPLASH_PALETTE_HPP
 
-#include "splash/Bitmap.hpp"
+#include "splash/BitmapView.hpp"
+#include "splash/ColourHistogram.hpp"
 #include "splash/filter/Filter.hpp"
+#include "splash/Quantizer.hpp"
 #include "splash/Swatch.hpp"
-#include "splash/target/Target.hpp"
+#include "splash/target/TargetSet.hpp"
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
-
-// boost::hash_combine
-template <class T>
-inline void hash_combine(size_t & seed, const T & v) {
-    seed ^= std::hash<T>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-}
-
-// Hashing function for a Target object
-namespace std {
-    template<> struct hash<Splash::Target::Target> {
-        const size_t operator()(const Splash::Target::Target & t) const {
-            size_t val = 0;
-            hash_combine(val, t.getMinimumLightness());
-            hash_combine(val, t.getTargetLightness());
-            hash_combine(val, t.getMaximumLightness());
-            hash_combine(val, t.getMinimumSaturation());
-            hash_combine(val, t.getTargetSaturation());
-            hash_combine(val, t.getMaximumSaturation());
-            hash_combine(val, t.getLightnessWeight());
-            hash_combine(val, t.getSaturationWeight());
-            hash_combine(val, t.getPopulationWeight());
-            hash_combine(val, t.isExclusive());
-            return val;
-        }
-    };
-};
 
 namespace Splash {
+    class QuantizerWorkspace;
+
     // Extracts prominent colours from an image. A number of colours with different profiles
     // are extracted:
     // - Vibrant                - Muted
     // - Vibrant Dark           - Muted Dark
     // - Vibrant Light          - Muted Light
     // Each one can get retrieved by a getter method.
-    // Note that creation is done via a Builder instance.
+    // Note that creation is done via a Builder instance. Palettes are plain values which can be
+    // copied or moved, and a Builder can generate into an existing Palette to reuse its buffers.
     class Palette {
         private:
             // Array of swatches in palette
             std::vector<Swatch> swatches;
-            // Array of targets in palette
-            std::vector<Target::Target> targets;
+            // Set of targets in palette
+            Target::TargetSet targets;
 
-            // Mapping from target to chosen swatch for target
-            std::unordered_map<Target::Target, Swatch> selectedSwatches;
-            // Mapping from colour (using raw int) to boolean indicating if used
-            std::unordered_map<int, bool> usedColours;
+            // Swatch chosen for each target (indexed by the target's handle)
+            std::vector<Swatch> selectedSwatches;
 
             // Dominant swatch in palette
             Swatch dominantSwatch;
 
-            Swatch findDominantSwatch();
-            float generateScore(const Swatch &, const Target::Target &);
-            Swatch generateScoredTarget(const Target::Target &);
-            Swatch getMaxScoredSwatchForTarget(const Target::Target &);
-            bool shouldBeScoredForTarget(const Swatch &, const Target::Target &);
+            // Buffers used while choosing the swatches, kept (empty) between generations so that
+            // generating into the same palette again doesn't reallocate them
+            std::vector<float> table;
+            std::vector<float> scores;
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> colours;
+            std::vector<uint64_t> used;
+
+            // Returned when a target has no swatch
+            static const Swatch INVALID_SWATCH;
+
+            Swatch findDominantSwatch() const;
 
-            // Actually generates the palette (invoked from Builder)
-            void generate();
+            // Fills the table with the saturation, lightness and population (relative to the dominant swatch)
+            // of the swatches as three separate arrays, so each is only converted to HSL once (see Simd::scoreTargets())
+            void createScoringTable();
 
-            // Constructor takes list of swatches and targets which form the palette
-            Palette(const std::vector<Swatch> &, const std::vector<Target::Target> &);
+            // Scores every swatch against each target in one pass, filling scores with one row per target
+            // Swatches outside of a target's range are given a score of -infinity
+            void scoreTargets();
 
-            // Copy constructors
-            Palette(const Palette &);
-            Palette(const Palette *);
+            // Fills colours with the index of each swatch's colour among the distinct colours of the
+            // swatches, so that swatches sharing a colour are marked as used together
+            void findColourIndices();
+
+            // Returns the index of the highest scoring swatch in the given row whose colour isn't
+            // marked as used, or -1 if there isn't one
+            int getMaxScoredSwatch(const float *) const;
+
+            // Actually generates the palette from the given swatches (which are swapped into the
+            // palette) and targets (invoked from Builder)
+            void generate(std::vector<Swatch> &, const Target::TargetSet &);
 
         public:
+            // Constructs an empty palette, which returns invalid swatches until a Builder generates into it
+            Palette();
+
             // Returns all the swatches that form the palette
-            std::vector<Swatch> getSwatches();
+            const std::vector<Swatch> & getSwatches() const;
 
             // Returns the targets used to generate the palette
-            std::vector<Target::Target> getTargets();
+            const std::vector<Target::Target> & getTargets() const;
 
             // Returns swatch generated matching the associated colour profile
             // If there is no swatch the returned swatch will be marked invalid
-            Swatch getVibrantSwatch();
-            Swatch getLightVibrantSwatch();
-            Swatch getDarkVibrantSwatch();
-            Swatch getMutedSwatch();
-            Swatch getLightMutedSwatch();
-            Swatch getDarkMutedSwatch();
+            // The returned references are valid until the palette is destroyed or generated into again.
+            const Swatch & getVibrantSwatch() const;
+            const Swatch & getLightVibrantSwatch() const;
+            const Swatch & getDarkVibrantSwatch() const;
+            const Swatch & getMutedSwatch() const;
+            const Swatch & getLightMutedSwatch() const;
+            const Swatch & getDarkMutedSwatch() const;
 
             // Return Swatch generated for matching target
             // If there is no swatch the returned swatch will be marked invalid
-            Swatch getSwatchForTarget(const Target::Target &);
+            const Swatch & getSwatchForTarget(const Target::Target &) const;
+
+            // Return Swatch generated for the target with the given handle (see Target::TargetSet),
+            // which avoids looking the target up
+            // If there is no swatch the returned swatch will be marked invalid
+            const Swatch & getSwatchForTarget(int) const;
 
             // Return the dominant swatch (swatch with greatest population)
             // If there is no swatch the returned swatch will be marked invalid
-            Swatch getDominantSwatch();
+            const Swatch & getDominantSwatch() const;
 
             // Return Colour generated matching the associated colour profile
             // Returns passed colour if no colour as generated
-            Colour getVibrantColour(const Colour &);
-            Colour getLightVibrantColour(const Colour &);
-            Colour getDarkVibrantColour(const Colour &);
-            Colour getMutedColour(const Colour &);
-            Colour getLightMutedColour(const Colour &);
-            Colour getDarkMutedColour(const Colour &);
-
-            // Return Colour generated for matching target
+            Colour getVibrantColour(const Colour &) const;
+            Colour getLightVibrantColour(const Colour &) const;
+            Colour getDarkVibrantColour(const Colour &) const;
+            Colour getMutedColour(const Colour &) const;
+            Colour getLightMutedColour(const Colour &) const;
+            Colour getDarkMutedColour(const Colour &) const;
+
+            // Return Colour generated for matching target (or the target with the given handle)
             // Returns passed colour if no colour as generated
-            Colour getColourForTarget(const Target::Target &, const Colour &);
+            Colour getColourForTarget(const Target::Target &, const Colour &) const;
+            Colour getColourForTarget(int, const Colour &) const;
 
             // Return the dominant colour (colour with greatest population)
             // Returns passed colour if no colour as generated
-            Colour getDominantColour(const Colour &);
+            Colour getDominantColour(const Colour &) const;
 
             // Builder class for generating Palette instances
             class Builder {
@@ -130,26 +134,48 @@ namespace Splash {
 
                     // Vectors to eventually pass to Palette constructor
                     std::vector<Swatch> swatches;
-                    std::vector<Target::Target> targets;
+                    Target::TargetSet targets;
 
-                    // Bitmap used to generate swatches
-                    Bitmap bitmap;
+                    // View of the pixels used to generate swatches (not copied!)
+                    BitmapView bitmap;
+                    // Counted colours used in place of the pixels (nullptr if the pixels are used)
+                    std::shared_ptr<const ColourHistogram> histogram;
                     // Region of bitmap to use for Palette generation
                     Region region;
                     // Variables for bitmap manipulation
                     size_t maxColours;
                     size_t resizeArea;
-
-                    std::vector<Colour> getPixelsFromBitmap(const Bitmap &);
-                    Bitmap scaleBitmapDown(const Bitmap &);
+                    // Number of threads used to count colours
+                    size_t threads;
+                    // Algorithm used to quantize the bitmap
+                    std::shared_ptr<Quantizer> quantizer;
+                    // Scratch memory used while quantizing (not deleted!)
+                    QuantizerWorkspace * workspace;
+                    // Number of bits kept from each colour component while quantizing
+                    int bitsPerComponent;
+                    // Maximum k-means iterations used to refine the swatches, and the time they may take (ms)
+                    int refineIterations;
+                    double refineBudget;
+
+                    // Returns the ratio to scale the bitmap by so that it fits within the resize area,
+                    // or a negative value if it doesn't need to be scaled
+                    double getScaleRatio();
+
+                    // Returns the swatches for each of the given maximum colour counts
+                    std::vector< std::vector<Swatch> > generateSwatches(const std::vector<size_t> &);
 
                 public:
-                    // Construct a Builder using a Bitmap
-                    Builder(const Bitmap &);
+                    // Construct a Builder using a view of some pixels (a Bitmap can also be passed)
+                    // The pixels are not copied, so they must outlive the Builder
+                    Builder(const BitmapView &);
 
                     // Construct a Builder using a vector of Swatches
                     Builder(const std::vector<Swatch> &);
 
+                    // Construct a Builder using colours which have already been counted (which are copied)
+                    // The scaling, region and bits per component are ignored, as the histogram sets them.
+                    Builder(const ColourHistogram &);
+
                     // Set the maximum number of colours to use in the quantization step
                     // when using a Bitmap as the source
                     // For landscapes, 10-16 is a good range
@@ -163,8 +189,46 @@ namespace Splash {
                     // This value greatly impacts processing time. The larger the resized image,
                     // the greater the palette generation will take. However, more detail will
                     // be preserved.
+                    // Passing 0 disables resizing so every pixel is counted. The histogram's bins and the
+                    // populations are 64-bit, so no count overflows; use setThreadCount() to keep it fast.
                     Builder & resizeBitmapArea(const size_t);
 
+                    // Set the number of threads used to count the colours in the Bitmap (and by the
+                    // quantizer, e.g. to split boxes when many colours are requested)
+                    // This is mainly worthwhile for large Bitmaps (e.g. with resizeBitmapArea(0)),
+                    // as small ones are always counted on the calling thread. The generated
+                    // palette is identical no matter how many threads are used.
+                    // Passing 0 uses one thread per hardware thread. Default is 1 thread.
+                    Builder & setThreadCount(const size_t);
+
+                    // Set the algorithm used to reduce the Bitmap's colours to swatches, by the name
+                    // it's registered under (see Quantizer). Unknown names are ignored.
+                    // Default is "ColourCut"
+                    Builder & setQuantizer(const std::string &);
+
+                    // Set the algorithm used to reduce the Bitmap's colours to swatches, which
+                    // doesn't need to be registered. nullptr is ignored.
+                    Builder & setQuantizer(const std::shared_ptr<Quantizer> &);
+
+                    // Set the workspace holding the scratch memory used while quantizing, which is
+                    // reused so that generating palettes repeatedly doesn't allocate. The workspace
+                    // must outlive the Builder and must only be used by one Builder at a time.
+                    // Default is nullptr, which uses a workspace owned by the calling thread.
+                    Builder & setWorkspace(QuantizerWorkspace *);
+
+                    // Set the number of bits kept from each colour component while quantizing (4 to 6)
+                    // 4 bits (4096 colours) is the fastest, as all of the counts fit in the CPU's cache,
+                    // while 6 bits (262144 colours) keeps more detail at the cost of speed.
+                    // Default is 5 bits, which matches Android.
+                    Builder & setBitsPerComponent(const int);
+
+                    // Set the maximum number of k-means iterations used to refine the quantized swatches
+                    // (see KMeans), and the time in milliseconds they may take (0 for no limit).
+                    // Refining picks out distinct colours better, so fewer colours can be requested
+                    // for the same result. At least one iteration is run if any are requested.
+                    // Default is 0 iterations (no refinement).
+                    Builder & setRefinement(const int, const double = 0);
+
                     // Clear all added filters (including the default ones)
                     Builder & clearFilters();
 
@@ -185,21 +249,42 @@ namespace Splash {
                     // The result can be retrieved using getSwatchForTarget(Target)
                     Builder & addTarget(const Target::Target &);
 
+                    // Replace all targets with the given set
+                    // The results can be retrieved using getSwatchForTarget() with the set's handles
+                    Builder & setTargets(const Target::TargetSet &);
+
                     // Clear all added targets (including the default ones)
                     Builder & clearTargets();
 
                     // Generate and return the generated Palette
                     // This is slow - so preferably use a separate thread!
-                    // The returned pointer must be deleted!
-                    std::shared_ptr<Palette> generate();
+                    Palette generate();
+
+                    // As above, but generates into the given Palette (replacing its contents). The palette
+                    // keeps the buffers used to choose swatches for the targets, so generating into the same
+                    // one repeatedly doesn't reallocate them (the swatches themselves come from the quantizer)
+                    void generate(Palette &);
+
+                    // Generate and return a Palette for each of the given maximum colour counts (in
+                    // place of the one set with setMaximumColourCount()). The pixels are only counted
+                    // once, and the default quantizer only splits its boxes once for all of them, so
+                    // this is much quicker than generating each separately. The results are identical.
+                    std::vector<Palette> generate(const std::vector<size_t> &);
+
+                    // As above, but generates into the given vector (resized to the number of counts)
+                    void generate(const std::vector<size_t> &, std::vector<Palette> &);
 
                     // Destructor deletes any added filters
                     ~Builder();
             };
 
-            // The actual method used to create a Palette from a bitmap
+            // The actual method used to create a Palette from a bitmap (or view of one)
             // Returns builder object which can be used to customize generation
-            static Builder from(const Bitmap &);
+            // The pixels are not copied, so they must outlive the returned Builder
+            static Builder from(const BitmapView &);
+
+            // Create a Palette from colours which have already been counted
+            static Builder from(const ColourHistogram &);
     };
 };
 
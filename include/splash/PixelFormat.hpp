@@ -0,0 +1,96 @@
+#ifndef SPLASH_PIXELFORMAT_HPP
+#define SPLASH_PIXELFORMAT_HPP
+
+#include "splash/Colour.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Splash {
+    // Describes how the pixels in a buffer are laid out in memory
+    enum class PixelFormat {
+        ARGB8888,   // 32-bit native-endian words of the form 0xAARRGGBB (same as Colour)
+        RGBA8888,   // 4 bytes per pixel in the order R, G, B, A
+        BGRA8888,   // 4 bytes per pixel in the order B, G, R, A
+        RGB888,     // 3 bytes per pixel in the order R, G, B (always opaque)
+        RGB565      // 16-bit native-endian words of the form RRRRRGGGGGGBBBBB (always opaque)
+    };
+
+    // Returns the number of bytes used to store a single pixel of the given format
+    size_t bytesPerPixel(PixelFormat);
+
+    // Converts a row of pixels of the given format into Colours
+    // Parameters: source, source format, number of pixels, destination
+    void convertRow(const void *, PixelFormat, size_t, Colour *);
+
+    // Reads the 8-bit components of a single pixel stored in the given format.
+    // Specialised per format so it can be inlined into per-row loops.
+    template <PixelFormat F>
+    struct PixelReader;
+
+    template <>
+    struct PixelReader<PixelFormat::ARGB8888> {
+        static const size_t size = 4;
+        static void read(const unsigned char * p, int & a, int & r, int & g, int & b) {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            a = v >> 24;
+            r = (v >> 16) & 0xff;
+            g = (v >> 8) & 0xff;
+            b = v & 0xff;
+        }
+    };
+
+    template <>
+    struct PixelReader<PixelFormat::RGBA8888> {
+        static const size_t size = 4;
+        static void read(const unsigned char * p, int & a, int & r, int & g, int & b) {
+            r = p[0];
+            g = p[1];
+            b = p[2];
+            a = p[3];
+        }
+    };
+
+    template <>
+    struct PixelReader<PixelFormat::BGRA8888> {
+        static const size_t size = 4;
+        static void read(const unsigned char * p, int & a, int & r, int & g, int & b) {
+            b = p[0];
+            g = p[1];
+            r = p[2];
+            a = p[3];
+        }
+    };
+
+    template <>
+    struct PixelReader<PixelFormat::RGB888> {
+        static const size_t size = 3;
+        static void read(const unsigned char * p, int & a, int & r, int & g, int & b) {
+            r = p[0];
+            g = p[1];
+            b = p[2];
+            a = 255;
+        }
+    };
+
+    template <>
+    struct PixelReader<PixelFormat::RGB565> {
+        static const size_t size = 2;
+        static void read(const unsigned char * p, int & a, int & r, int & g, int & b) {
+            uint16_t v;
+            std::memcpy(&v, p, sizeof(v));
+
+            // Expand to 8 bits by replicating the most significant bits
+            int r5 = v >> 11;
+            int g6 = (v >> 5) & 0x3f;
+            int b5 = v & 0x1f;
+            r = (r5 << 3) | (r5 >> 2);
+            g = (g6 << 2) | (g6 >> 4);
+            b = (b5 << 3) | (b5 >> 2);
+            a = 255;
+        }
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef SPLASH_QUANTIZER_HPP
+#define SPLASH_QUANTIZER_HPP
+
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Swatch.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Splash {
+    class QuantizerWorkspace;
+
+    // A quantizer reduces the colours counted in a histogram to a palette of swatches.
+    // Quantizers are registered under a name, so the one used can be chosen each time a
+    // palette is generated (see Palette::Builder::setQuantizer()). Three are built in:
+    //  - "ColourCut": modified median cut (default, matches Android's Palette)
+    //  - "Octree": octree with a fixed node budget (see OctreeQuantizer)
+    //  - "Wu": Wu's variance minimisation (faster, especially for large colour counts)
+    class Quantizer {
+        public:
+            // Inherited to form new quantizers. Reduces the colours counted in the workspace
+            // to at most the given number of swatches. The histogram has already been filtered,
+            // so it only contains allowed colours, which are listed in the workspace's colours
+            // (see Histogram::filter()). The mask can be used to check any colours which are
+            // formed by averaging. The workspace is cleared by the caller afterwards.
+            // Parameters: workspace, maximum number of colours, mask of allowed colours,
+            // number of threads which may be used (the builder's thread count)
+            virtual std::vector<Swatch> quantize(QuantizerWorkspace &, int, const std::shared_ptr<const Filter::FilterMask> &, size_t) = 0;
+
+            // Same as above, but returns the swatches for each of the given numbers of colours.
+            // By default quantize() is called for each, but it can be overridden to share the work
+            // (e.g. ColourCut splits once for the largest count and cuts the splits short for the others).
+            virtual std::vector< std::vector<Swatch> > quantizeEach(QuantizerWorkspace &, const std::vector<int> &, const std::shared_ptr<const Filter::FilterMask> &, size_t);
+
+            virtual ~Quantizer();
+
+            // Registers a quantizer under the given name, replacing any already using it
+            static void add(const std::string &, const std::shared_ptr<Quantizer> &);
+
+            // Returns the quantizer registered under the given name, or nullptr if there isn't one
+            static std::shared_ptr<Quantizer> get(const std::string &);
+
+            // Returns the names of all registered quantizers
+            static std::vector<std::string> names();
+    };
+};
+
+#endif
\ No newline at end of file
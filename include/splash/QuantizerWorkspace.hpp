@@ -0,0 +1,80 @@
+#ifndef SPLASH_QUANTIZERWORKSPACE_HPP
+#define SPLASH_QUANTIZERWORKSPACE_HPP
+
+#include "splash/AreaScaler.hpp"
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/WorkerPool.hpp"
+#include "splash/WuQuantizer.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Splash {
+    // Scratch memory used by the quantizers, which can be kept between quantizations so that
+    // repeatedly generating palettes doesn't allocate (or clear) it every time.
+    // Each quantizer only uses the workspace while it's being constructed, and leaves it ready
+    // for the next one. The histogram is left all zero by clearing only the bins that were used.
+    // A workspace must not be used by more than one quantizer at a time.
+    class QuantizerWorkspace {
+        private:
+            // Number of bits kept from each component when counting
+            int wordWidth;
+
+        public:
+            // Histogram of quantized colour frequency (all zero when not in use)
+            std::vector<int64_t> histogram;
+
+            // Histogram with 16-bit bins, used to count small numbers of pixels (all zero when not in use)
+            std::vector<uint16_t> compact;
+
+            // One bit per bin of the histogram, set if the bin is non-zero (all zero when not in use)
+            std::vector<uint64_t> occupancy;
+
+            // Histograms filled by other threads when counting on more than one
+            std::vector< std::vector<int64_t> > partials;
+
+            // Scaler and row buffer used when scaling while counting
+            AreaScaler scaler;
+            std::vector<Colour> row;
+
+            // Distinct colours within the histogram (also used to know which bins to clear)
+            std::vector<uint32_t> colours;
+
+            // Heap of boxes and boxes split ahead of time used by ColourCutQuantizer
+            std::vector<ColourCutQuantizer::Vbox> boxes;
+            std::vector<ColourCutQuantizer::Split> splits;
+
+            // Moment tables, boxes and their variances used by WuQuantizer
+            std::vector<int64_t> weights;
+            std::vector<int64_t> momentsR;
+            std::vector<int64_t> momentsG;
+            std::vector<int64_t> momentsB;
+            std::vector<double> moments2;
+            std::vector<WuQuantizer::Box> wuBoxes;
+            std::vector<double> variances;
+
+            // Points, centroids, assignments (current and previous) and sums used by KMeans::refine()
+            std::vector<float> points;
+            std::vector<float> centroids;
+            std::vector<uint32_t> nearest;
+            std::vector<uint32_t> previous;
+            std::vector<double> sums;
+
+            // Threads kept between jobs, used when counting and splitting boxes ahead on more than one
+            WorkerPool workers;
+
+            // Constructs a workspace with empty histograms, using the default word width
+            QuantizerWorkspace();
+
+            // Returns the number of bits kept from each component when counting
+            int getWordWidth() const;
+
+            // Set the number of bits kept from each component (clamped to the supported range)
+            // The histograms are only reallocated if the width changes
+            void setWordWidth(int);
+
+            // Returns the workspace belonging to the calling thread, used by default when one isn't given
+            static QuantizerWorkspace & local();
+    };
+};
+
+#endif
\ No newline at end of file
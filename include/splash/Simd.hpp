@@ -0,0 +1,71 @@
+#ifndef SPLASH_SIMD_HPP
+#define SPLASH_SIMD_HPP
+
+#include "splash/Colour.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Contains the vectorized kernels used in the library's hot loops. Each kernel
+// has a scalar fallback, and the implementation to use is chosen at runtime
+// based on what the CPU supports.
+namespace Splash::Simd {
+    // Instruction sets which kernels may be implemented with
+    enum class ISA {
+        Scalar,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    // Returns the best instruction set supported by the running CPU
+    ISA detectISA();
+
+    // Returns whether the given instruction set can be used on the running CPU
+    bool isSupported(ISA);
+
+    // Returns the instruction set currently used by the kernels
+    // Defaults to detectISA()
+    ISA getISA();
+
+    // Force the kernels to use the given instruction set (mainly for testing/benchmarking)
+    // Returns false and does nothing if it isn't supported
+    bool setISA(ISA);
+
+    // Returns a readable name for the given instruction set
+    const char * toString(ISA);
+
+    // Adds each byte of each pixel in the row to the matching 32-bit accumulator
+    // (four per pixel, kept in the same order as the pixel's bytes in memory)
+    // Parameters: pixels, number of pixels, accumulators
+    void accumulateRow(const Colour *, size_t, uint32_t *);
+
+    // Adds each count in the first array to the matching count in the second
+    // Parameters: counts to add, number of counts, counts to add to
+    void addCounts(const uint64_t *, size_t, uint64_t *);
+
+    // Converts each 0xAARRGGBB word to the 15-bit histogram index formed by the
+    // top five bits of each of red, green and blue (alpha is dropped)
+    // Parameters: pixels, number of pixels, indices
+    void quantizeRow(const uint32_t *, size_t, uint16_t *);
+
+    // Finds the index of the centroid nearest to each point (by squared euclidean distance,
+    // with ties going to the lowest index). Points are stored as four floats each (the last
+    // is ignored), while the centroids are stored as three arrays of each component in turn.
+    // The number of centroids must be a multiple of eight (pad with distant centroids).
+    // Parameters: points, number of points, centroids, number of centroids, nearest indices
+    void nearestCentroids(const float *, size_t, const float *, size_t, uint32_t *);
+
+    // Number of floats describing each target passed to scoreTargets()
+    const size_t TARGET_SIZE = 9;
+
+    // Scores every swatch against each target as Palette does, writing one row of scores per target.
+    // Swatches are stored as three arrays of saturation, lightness and population (relative to the
+    // dominant swatch) in turn. Each target is stored as TARGET_SIZE floats: the saturation, lightness and
+    // population weights (which must not be negative), the target saturation and lightness, then the
+    // minimum and maximum saturation and the minimum and maximum lightness. Swatches outside of a
+    // target's range are given a score of -infinity.
+    // Parameters: swatches, number of swatches, targets, number of targets, scores
+    void scoreTargets(const float *, size_t, const float *, size_t, float *);
+};
+
+#endif
\ No newline at end of file
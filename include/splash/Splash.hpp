@@ -2,8 +2,11 @@
 #define SPLASH_SPLASH_HPP
 
 // Include all headers (majority are included in MediaStyle)
+#include "splash/ColourHistogram.hpp"
 #include "splash/ColourUtils.hpp"
 #include "splash/MediaStyle.hpp"
+#include "splash/OctreeQuantizer.hpp"
+#include "splash/SplitTree.hpp"
 #include "splash/Utils.hpp"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef SPLASH_SPLITTREE_HPP
+#define SPLASH_SPLITTREE_HPP
+
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include <memory>
+#include <vector>
+
+namespace Splash {
+    // Records the boxes split by ColourCutQuantizer, so that the palette for any number of
+    // colours can be found without counting or splitting again. Median cut always splits
+    // boxes in the same order, so quantizing to k colours is the same as stopping after
+    // the first k - 1 splits. The swatches returned for each count are identical to those
+    // from a ColourCutQuantizer asked for that many colours.
+    // The tree keeps using the counted colours, so more colours can be asked for than it was
+    // first built with, in which case it's split further.
+    class SplitTree {
+        public:
+            // A box of colours within the tree, along with its average colour and population
+            // Children are -1 if the box hasn't been split.
+            struct Node {
+                Swatch swatch;
+                int lower;
+                int upper;
+            };
+
+        private:
+            // Workspace used when the tree counts the pixels itself
+            std::unique_ptr<QuantizerWorkspace> owned;
+            // Holds the counted colours (the caller's, unless the tree counted them itself)
+            QuantizerWorkspace & workspace;
+            // Colours allowed by the filters
+            std::shared_ptr<const Filter::FilterMask> mask;
+            // Number of threads used to split boxes
+            size_t threads;
+
+            // Nodes in the order they were created (the root is first), and their boxes
+            std::vector<Node> nodes;
+            std::vector<ColourCutQuantizer::Vbox> boxes;
+            // Node split by each split in order
+            std::vector<int> splits;
+            // Heap of boxes still to be split
+            std::vector<ColourCutQuantizer::Vbox> heap;
+            // Node of each leaf, indexed by the position of the leaf's first colour (leaves
+            // never share colours, so this is unique)
+            std::vector<int> leaves;
+            // Splits made while growing
+            std::vector<ColourCutQuantizer::Split> history;
+            // Whether splitting has stopped as the next box couldn't be split
+            bool stopped;
+
+            // Splits boxes until there are the given number of colours (or no more can be split)
+            void grow(int);
+            template <int W>
+            void grow(int);
+
+            // Returns the swatches for the given number of colours (once enough splits are recorded)
+            template <int W>
+            std::vector<Swatch> cut(int) const;
+
+            // Creates the root node and splits it to the given number of colours
+            void build(int);
+
+        public:
+            // Constructor takes a view of the pixels to quantize, the number of colours to split to
+            // straight away, a vector of filters to use and optionally the number of threads to use
+            // and the number of bits kept from each component (as for ColourCutQuantizer)
+            // The pixels are counted into a workspace belonging to the tree.
+            SplitTree(const BitmapView &, int, std::vector<Filter::Filter *> &, size_t = 1, int = Histogram::WORD_WIDTH);
+
+            // Constructor takes a workspace which has already been counted and filtered with the given
+            // mask, followed by the same parameters as above. The workspace is used in place (its colours
+            // are reordered), so it must not be cleared or used by anything else until the tree is gone.
+            SplitTree(QuantizerWorkspace &, int, const std::shared_ptr<const Filter::FilterMask> &, size_t = 1);
+
+            // Returns the swatches for the given number of colours, splitting further if needed
+            std::vector<Swatch> getQuantizedColours(int);
+
+            // Returns the nodes of the tree (the root is first, followed by the two halves of each split)
+            const std::vector<Node> & getNodes() const;
+
+            // Returns the node split by each split, in the order they were made
+            const std::vector<int> & getSplits() const;
+    };
+};
+
+#endif
\ No newline at end of file
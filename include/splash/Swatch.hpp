@@ -2,6 +2,7 @@
 #define SPLASH_SWATCH_HPP
 
 #include "splash/Colour.hpp"
+#include <cstdint>
 #include <string>
 
 namespace Splash {
@@ -11,26 +12,26 @@ namespace Splash {
             // Is this swatch valid?
             bool valid;
 
-            // Number of pixels that formed this swatch
-            int population;
+            // Number of pixels that formed this swatch (64-bit so full resolution images can't overflow it)
+            int64_t population;
 
             // The original colour
             Colour colour;
 
             // Generated colours
-            bool coloursGenerated;
-            Colour titleTextColour;
-            Colour bodyTextColour;
+            mutable bool coloursGenerated;
+            mutable Colour titleTextColour;
+            mutable Colour bodyTextColour;
 
             // Generate colours above and set flag
-            void generateColours();
+            void generateColours() const;
 
         public:
             // Creates an invalid swatch
             Swatch();
 
             // Constructor takes colour and population
-            Swatch(Colour, int);
+            Swatch(Colour, int64_t);
 
             // Returns if the swatch is valid
             bool isValid() const;
@@ -39,18 +40,18 @@ namespace Splash {
             Colour getColour() const;
 
             // Returns number of pixels represented by swatch
-            int getPopulation() const;
+            int64_t getPopulation() const;
 
             // Returns an appropriate colour to use for any title text
             // to display on top of the swatch's colour
-            Colour getTitleTextColour();
+            Colour getTitleTextColour() const;
 
             // Returns an appropriate colour to use for any body text
             // to display on top of the swatch's colour
-            Colour getBodyTextColour();
+            Colour getBodyTextColour() const;
 
             // Return the contents of the swatch as a string
-            std::string toString();
+            std::string toString() const;
 
             // Equality operator
             bool operator==(const Swatch) const;
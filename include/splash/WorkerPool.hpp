@@ -0,0 +1,60 @@
+#ifndef SPLASH_WORKERPOOL_HPP
+#define SPLASH_WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Splash {
+    // Threads which are kept waiting between jobs, so that work repeatedly split across threads
+    // (e.g. each time boxes are split ahead) doesn't start and join new threads every time.
+    // Threads are only started once a job needs them, and are joined when the pool is destroyed.
+    // A pool must not be used to run more than one job at a time.
+    class WorkerPool {
+        private:
+            // Threads started so far (the calling thread always runs the first part of a job)
+            std::vector<std::thread> threads;
+
+            // Guards everything below, and wakes the threads when there's a new job (or they should stop)
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable finished;
+
+            // Current job, the number of parts it's split into and the number still running on other threads
+            const std::function<void(size_t)> * job;
+            size_t parts;
+            size_t remaining;
+
+            // Incremented for each job so that each thread only runs its part once
+            size_t generation;
+
+            // Set when the pool is destroyed
+            bool stopping;
+
+            // Loop run by each thread, waiting for and running the given part of each job
+            void work(size_t);
+
+        public:
+            // Constructs a pool without any threads
+            WorkerPool();
+
+            // Pools own their threads, so can't be copied
+            WorkerPool(const WorkerPool &) = delete;
+            WorkerPool & operator=(const WorkerPool &) = delete;
+
+            // Stops and joins every thread
+            ~WorkerPool();
+
+            // Returns the number of threads started so far
+            size_t size();
+
+            // Calls the function with each part in [0, parts), the first on the calling thread and
+            // the others on the pool's threads, returning once every part has finished
+            void run(size_t, const std::function<void(size_t)> &);
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef SPLASH_WUQUANTIZER_HPP
+#define SPLASH_WUQUANTIZER_HPP
+
+#include "splash/BitmapView.hpp"
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/filter/Filter.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/Swatch.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Splash {
+    class QuantizerWorkspace;
+
+    // Colour quantizer based on Xiaolin Wu's algorithm (Graphics Gems II, "Efficient
+    // Statistical Computations for Optimal Color Quantization").
+    // It operates on the same histogram of quantized colours as ColourCutQuantizer, but
+    // instead of sorting colours it stores cumulative moments of the histogram in 3D tables.
+    // The population, colour sums and variance of any box can then be found with a fixed
+    // number of lookups, and the box with the greatest variance is repeatedly split at the
+    // point which minimises the variance of the two halves.
+    class WuQuantizer {
+        private:
+            // The workspace stores Boxes
+            friend class QuantizerWorkspace;
+
+            // A box within the colour cube. Lower bounds are exclusive and upper bounds are
+            // inclusive, both as indices into the moment tables.
+            struct Box {
+                int r0, r1;
+                int g0, g1;
+                int b0, b1;
+            };
+
+            // Workspace providing scratch memory (only used during construction)
+            QuantizerWorkspace & workspace;
+
+            // Histogram of quantized colour frequency, and the colours within it, held in the workspace
+            std::vector<int64_t> & histogram;
+            std::vector<uint32_t> & colours;
+
+            // Cumulative moment tables (one larger than the histogram in each dimension), held in the workspace
+            // Population, sum of each component and sum of squared components
+            std::vector<int64_t> & weights;
+            std::vector<int64_t> & momentsR;
+            std::vector<int64_t> & momentsG;
+            std::vector<int64_t> & momentsB;
+            std::vector<double> & moments2;
+
+            // Pointers to passed filters (not deleted!)
+            std::vector<Filter::Filter *> filters;
+            // Colours allowed by the filters
+            std::shared_ptr<const Filter::FilterMask> mask;
+            // Quantized colours stored as Swatches
+            std::vector<Swatch> quantizedColours;
+
+            // Filters the counted histogram and reduces it to the given number of colours,
+            // then clears the used parts of the workspace
+            void quantizeHistogram(int);
+
+            // Reduces the filtered colours to the given number of colours
+            void reduceColours(int);
+
+            // The methods below are templated on the word width (W bits per component),
+            // which sets the size of the moment tables
+
+            // Reduces the listed colours to the given number of colours by splitting boxes
+            template <int W>
+            void quantizeBoxes(int);
+
+            // Fills the moment tables from the histogram
+            template <int W>
+            void computeMoments();
+
+            // Returns the sum of the given moment within the box
+            template <int W>
+            static int64_t volume(const Box &, const std::vector<int64_t> &);
+            template <int W>
+            static double volume(const Box &, const std::vector<double> &);
+
+            // Returns the part of the box's sum which doesn't depend on the upper bound in the given dimension
+            template <int W>
+            static int64_t bottom(const Box &, Dimension, const std::vector<int64_t> &);
+
+            // Returns the part of the box's sum which depends on the upper bound in the given dimension,
+            // with that bound replaced by the given position
+            template <int W>
+            static int64_t top(const Box &, Dimension, int, const std::vector<int64_t> &);
+
+            // Returns the weighted variance of the colours within the box
+            template <int W>
+            double variance(const Box &) const;
+
+            // Finds the position to cut the box in the given dimension which best separates its colours
+            // Parameters: box, dimension, first and last (exclusive) positions to try, returned position
+            // (or -1 if none) and the box's total moments
+            // Returns a score for the cut (higher is better)
+            template <int W>
+            double maximize(const Box &, Dimension, int, int, int &, int64_t, int64_t, int64_t, int64_t) const;
+
+            // Splits the first box in two, placing the second half in the second box
+            // Returns false if the box can't be split
+            template <int W>
+            bool cut(Box &, Box &) const;
+
+        public:
+            // Constructor takes a view of the pixels to quantize, the maximum number of colours in the
+            // resulting palette, a vector of filters to use and optionally the number of threads to use
+            // when counting colours, the workspace to use (nullptr uses the calling thread's workspace)
+            // and the number of bits kept from each component (between Histogram::MIN_WORD_WIDTH and MAX_WORD_WIDTH)
+            WuQuantizer(const BitmapView &, int, std::vector<Filter::Filter *> &, size_t = 1, QuantizerWorkspace * = nullptr, int = Histogram::WORD_WIDTH);
+
+            // As above, but scales the pixels to the given width and height while counting
+            WuQuantizer(const BitmapView &, size_t, size_t, int, std::vector<Filter::Filter *> &, size_t = 1, QuantizerWorkspace * = nullptr, int = Histogram::WORD_WIDTH);
+
+            // Constructor takes a workspace which has already been counted and filtered with the given
+            // mask (see Histogram::filter()), and the maximum number of colours in the resulting palette.
+            // The workspace isn't cleared afterwards.
+            WuQuantizer(QuantizerWorkspace &, int, const std::shared_ptr<const Filter::FilterMask> &);
+
+            // Returns vector of quantized colours as Swatches
+            std::vector<Swatch> getQuantizedColours();
+    };
+};
+
+#endif
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace Splash::Filter {
         public:
             // Overrides to provide mentioned behaviour
             bool isAllowed(Colour &);
+            std::string identifier() const;
     };
 };
 
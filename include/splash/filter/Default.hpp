@@ -18,6 +18,7 @@ namespace Splash::Filter {
         public:
             // Overrides to provide mentioned checks
             bool isAllowed(Colour &);
+            std::string identifier() const;
     };
 };
 
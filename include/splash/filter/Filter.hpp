@@ -2,6 +2,7 @@
 #define SPLASH_FILTER_FILTER_HPP
 
 #include "splash/Colour.hpp"
+#include <string>
 
 namespace Splash::Filter {
     // A filter provides a mechanism for controlling which colours are valid
@@ -12,6 +13,13 @@ namespace Splash::Filter {
             // Returns true if allowed, false if not
             virtual bool isAllowed(Colour &) = 0;
 
+            // Returns a string which uniquely identifies this filter's parameters, allowing its results
+            // to be cached (see FilterMask, which also keys on the filter's type, so subclasses which
+            // only override isAllowed() are cached separately)
+            // Filters which return an empty string (the default) are never cached, and subclasses which
+            // add parameters of their own must override this to include them
+            virtual std::string identifier() const;
+
             virtual ~Filter();
     };
 };
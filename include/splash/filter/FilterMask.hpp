@@ -0,0 +1,53 @@
+#ifndef SPLASH_FILTER_FILTERMASK_HPP
+#define SPLASH_FILTER_FILTERMASK_HPP
+
+#include "splash/filter/Filter.hpp"
+#include "splash/Histogram.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Splash::Filter {
+    // A filter mask is the result of running a chain of filters over every quantized
+    // (RGB555 by default) colour once, stored as one bit per colour. Masks for chains where every
+    // filter has an identifier are cached (keyed by each filter's type and identifier), so the filters are only evaluated the first
+    // time the chain is seen.
+    class FilterMask {
+        private:
+            // One bit per colour, set if allowed by every filter
+            std::vector<uint64_t> bits;
+
+            // Number of bits kept from each component of the colours
+            int wordWidth;
+
+            // Evaluates the filters for every colour quantized to the given word width
+            FilterMask(const std::vector<Filter *> &, int);
+
+        public:
+            // Number of colours (bits) in a mask using the default word width
+            static const size_t size = Histogram::SIZE;
+
+            // Number of 64-bit words in a mask using the default word width
+            static const size_t words = size/64;
+
+            // Returns the mask for the given chain of filters, using the cached one if possible
+            // Masks for chains containing a filter without an identifier are never cached
+            // Parameters: filters, word width of the quantized colours
+            static std::shared_ptr<const FilterMask> get(const std::vector<Filter *> &, int = Histogram::WORD_WIDTH);
+
+            // Removes all cached masks
+            static void clearCache();
+
+            // Returns the number of bits kept from each component of the colours
+            int getWordWidth() const;
+
+            // Returns whether the given quantized colour (RGB555 by default) is allowed
+            bool isAllowed(size_t) const;
+
+            // Returns the mask as an array of 64-bit words (bit i of word w represents colour (w * 64) + i)
+            const uint64_t * data() const;
+    };
+};
+
+#endif
\ No newline at end of file
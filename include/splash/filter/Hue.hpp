@@ -18,6 +18,7 @@ namespace Splash::Filter {
 
             // Overrides to provide mentioned behaviour
             bool isAllowed(Colour &);
+            std::string identifier() const;
     };
 };
 
@@ -4,14 +4,8 @@
 #include "splash/target/Target.hpp"
 
 namespace Splash::Target {
-    // Inherits Target to invoke methods to create the static DARK_MUTED target
-    class DarkMuted : public Target {
-        public:
-            DarkMuted();
-    };
-
-    // Static instance
-    static DarkMuted DARK_MUTED;
+    // Target matching dark, muted colours
+    constexpr Target DARK_MUTED = Target({{0.0f, TARGET_MUTED_SATURATION, MAX_MUTED_SATURATION}}, {{0.0f, TARGET_DARK_LUMA, MAX_DARK_LUMA}});
 };
 
 #endif
\ No newline at end of file
@@ -4,14 +4,8 @@
 #include "splash/target/Target.hpp"
 
 namespace Splash::Target {
-    // Inherits Target to invoke methods to create the static DARK_VIBRANT target
-    class DarkVibrant : public Target {
-        public:
-            DarkVibrant();
-    };
-
-    // Static instance
-    static DarkVibrant DARK_VIBRANT;
+    // Target matching dark, vibrant colours
+    constexpr Target DARK_VIBRANT = Target({{MIN_VIBRANT_SATURATION, TARGET_VIBRANT_SATURATION, 1.0f}}, {{0.0f, TARGET_DARK_LUMA, MAX_DARK_LUMA}});
 };
 
 #endif
\ No newline at end of file
@@ -4,14 +4,8 @@
 #include "splash/target/Target.hpp"
 
 namespace Splash::Target {
-    // Inherits Target to invoke methods to create the static LIGHT_MUTED target
-    class LightMuted : public Target {
-        public:
-            LightMuted();
-    };
-
-    // Static instance
-    static LightMuted LIGHT_MUTED;
+    // Target matching light, muted colours
+    constexpr Target LIGHT_MUTED = Target({{0.0f, TARGET_MUTED_SATURATION, MAX_MUTED_SATURATION}}, {{MIN_LIGHT_LUMA, TARGET_LIGHT_LUMA, 1.0f}});
 };
 
 #endif
\ No newline at end of file
@@ -4,14 +4,8 @@
 #include "splash/target/Target.hpp"
 
 namespace Splash::Target {
-    // Inherits Target to invoke methods to create the static LIGHT_VIBRANT target
-    class LightVibrant : public Target {
-        public:
-            LightVibrant();
-    };
-
-    // Static instance
-    static LightVibrant LIGHT_VIBRANT;
+    // Target matching light, vibrant colours
+    constexpr Target LIGHT_VIBRANT = Target({{MIN_VIBRANT_SATURATION, TARGET_VIBRANT_SATURATION, 1.0f}}, {{MIN_LIGHT_LUMA, TARGET_LIGHT_LUMA, 1.0f}});
 };
 
 #endif
\ No newline at end of file
@@ -4,14 +4,8 @@
 #include "splash/target/Target.hpp"
 
 namespace Splash::Target {
-    // Inherits Target to invoke methods to create the static MUTED target
-    class Muted : public Target {
-        public:
-            Muted();
-    };
-
-    // Static instance
-    static Muted MUTED;
+    // Target matching muted colours
+    constexpr Target MUTED = Target({{0.0f, TARGET_MUTED_SATURATION, MAX_MUTED_SATURATION}}, {{MIN_NORMAL_LUMA, TARGET_NORMAL_LUMA, MAX_NORMAL_LUMA}});
 };
 
 #endif
\ No newline at end of file
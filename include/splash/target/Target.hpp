@@ -1,39 +1,48 @@
 #ifndef SPLASH_TARGET_TARGET_HPP
 #define SPLASH_TARGET_TARGET_HPP
 
-#include <vector>
+#include <array>
 
 namespace Splash::Target {
+    // Values used by the default targets
+    constexpr float TARGET_DARK_LUMA = 0.26f;
+    constexpr float MAX_DARK_LUMA = 0.45f;
+    constexpr float MIN_LIGHT_LUMA = 0.55f;
+    constexpr float TARGET_LIGHT_LUMA = 0.74f;
+    constexpr float MIN_NORMAL_LUMA = 0.3f;
+    constexpr float TARGET_NORMAL_LUMA = 0.5f;
+    constexpr float MAX_NORMAL_LUMA = 0.7f;
+    constexpr float TARGET_MUTED_SATURATION = 0.3f;
+    constexpr float MAX_MUTED_SATURATION = 0.4f;
+    constexpr float TARGET_VIBRANT_SATURATION = 1.0f;
+    constexpr float MIN_VIBRANT_SATURATION = 0.35f;
+    constexpr float WEIGHT_SATURATION = 0.24f;
+    constexpr float WEIGHT_LUMA = 0.52f;
+    constexpr float WEIGHT_POPULATION = 0.24f;
+
     // A Target allows custom selection of colours in a Palette's generation
+    // Targets are plain values (with no heap allocation), so they can be copied freely
+    // and the default ones are constants.
     class Target {
         private:
-            // Initialize weights array with default values
-            void setDefaultWeights();
-            // Initialize given array with default values
-            void setTargetDefaultValues(std::vector<float> &);
-
-        protected:
             // Is any colour selected for this target exclusive to this target?
             bool isExclusive_;
 
-            // Arrays of target values
-            std::vector<float> lightnessTargets;
-            std::vector<float> saturationTargets;
-            std::vector<float> weights;
-
-            // Functions called by derived instances to set up their values
-            void setDefaultLightLightnessValues();
-            void setDefaultNormalLightnessValues();
-            void setDefaultDarkLightnessValues();
-            void setDefaultVibrantSaturationValues();
-            void setDefaultMutedSaturationValues();
+            // Arrays of target values (minimum, target, maximum)
+            std::array<float, 3> lightnessTargets;
+            std::array<float, 3> saturationTargets;
+            // Weights of saturation, lightness and population
+            std::array<float, 3> weights;
 
         public:
-            // Constructor creates target but doesn't set values
-            Target();
+            // Constructor creates target with the default values (accepting any colour)
+            constexpr Target() : isExclusive_(true), lightnessTargets{{0.0f, 0.5f, 1.0f}}, saturationTargets{{0.0f, 0.5f, 1.0f}}, weights{{WEIGHT_SATURATION, WEIGHT_LUMA, WEIGHT_POPULATION}} {}
+
+            // Constructor takes the saturation and lightness values (each minimum, target, maximum),
+            // and optionally the weights (saturation, lightness, population) and whether it's exclusive
+            constexpr Target(const std::array<float, 3> & s, const std::array<float, 3> & l, const std::array<float, 3> & w = {{WEIGHT_SATURATION, WEIGHT_LUMA, WEIGHT_POPULATION}}, bool e = true) : isExclusive_(e), lightnessTargets(l), saturationTargets(s), weights(w) {}
 
-            // Copy constructors
-            Target(const Target &);
+            // Copy constructor
             Target(const Target *);
 
             // Returns the minimum saturation value of the target
@@ -67,57 +76,56 @@ namespace Splash::Target {
             // Normalize the target's weights
             void normalizeWeights();
 
-            // Nested builder class
-            class Builder {
-                private:
-                    Target * target;
-
-                public:
-                    // Create a target from scratch (default values)
-                    Builder();
-
-                    // Create a new builder based on an existing target
-                    Builder(Target &);
-
-                    // Set the minimum saturation value of the target
-                    Builder & setMinimumSaturation(float);
-                    // Set the target saturation value for the target
-                    Builder & setTargetSaturation(float);
-                    // Set the maximum saturation value of this target
-                    Builder & setMaximumSaturation(float);
-                    // Set the weight of importance the target places on
-                    // the image's colour saturation
-                    Builder & setSaturationWeight(float);
-
-                    // Set the minimum lightness value of the target
-                    Builder & setMinimumLightness(float);
-                    // Set the target lightness value for the target
-                    Builder & setTargetLightness(float);
-                    // Set the maximum lightness value of this target
-                    Builder & setMaximumLightness(float);
-                    // Set the weight of importance the target places on
-                    // the image's colour lightness
-                    Builder & setLightnessWeight(float);
-
-                    // Set the weight of importance the target places on
-                    // the image's colour population
-                    Builder & setPopulationWeight(float);
-
-                    // Set whether any colour selected for this target is
-                    // exclusive to the target
-                    Builder & setExclusive(bool);
-
-                    // Build and return the created target
-                    Target build();
-
-                    // Delete the Target object stored on the heap
-                    ~Builder();
-            };
+            // Nested builder class (defined below)
+            class Builder;
 
         // Equality operator
         bool operator==(const Target) const;
     };
 
+    // Builds a Target by setting each of its values in turn
+    class Target::Builder {
+        private:
+            Target target;
+
+        public:
+            // Create a target from scratch (default values)
+            Builder();
+
+            // Create a new builder based on an existing target
+            Builder(const Target &);
+
+            // Set the minimum saturation value of the target
+            Builder & setMinimumSaturation(float);
+            // Set the target saturation value for the target
+            Builder & setTargetSaturation(float);
+            // Set the maximum saturation value of this target
+            Builder & setMaximumSaturation(float);
+            // Set the weight of importance the target places on
+            // the image's colour saturation
+            Builder & setSaturationWeight(float);
+
+            // Set the minimum lightness value of the target
+            Builder & setMinimumLightness(float);
+            // Set the target lightness value for the target
+            Builder & setTargetLightness(float);
+            // Set the maximum lightness value of this target
+            Builder & setMaximumLightness(float);
+            // Set the weight of importance the target places on
+            // the image's colour lightness
+            Builder & setLightnessWeight(float);
+
+            // Set the weight of importance the target places on
+            // the image's colour population
+            Builder & setPopulationWeight(float);
+
+            // Set whether any colour selected for this target is
+            // exclusive to the target
+            Builder & setExclusive(bool);
+
+            // Build and return the created target
+            Target build();
+    };
 };
 
 #endif
\ No newline at end of file
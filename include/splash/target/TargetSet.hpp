@@ -0,0 +1,71 @@
+#ifndef SPLASH_TARGET_TARGETSET_HPP
+#define SPLASH_TARGET_TARGETSET_HPP
+
+#include "splash/target/Target.hpp"
+#include <vector>
+
+namespace Splash::Target {
+    // The default targets (see TargetSet::getDefaultHandle())
+    enum class Default {
+        Vibrant,
+        LightVibrant,
+        DarkVibrant,
+        Muted,
+        LightMuted,
+        DarkMuted
+    };
+
+    // Number of default targets
+    const size_t NUM_DEFAULTS = 6;
+
+    // An ordered set of targets which a Palette picks swatches for. Each target added is given
+    // an integer handle (its position in the set), which can be used to retrieve the chosen
+    // swatch from a Palette without looking the target up. Targets are compiled as they're
+    // added: their weights are normalized once and their values are packed in the layout used
+    // to score swatches (see Simd::scoreTargets()).
+    class TargetSet {
+        private:
+            // Targets as they were added
+            std::vector<Target> targets;
+            // Normalized values of each target, Simd::TARGET_SIZE floats per target
+            std::vector<float> values;
+            // Handle of each default target, or -1 if it hasn't been added (found as targets are added
+            // so that a Palette's default getters don't have to look them up)
+            int defaultHandles[NUM_DEFAULTS];
+
+        public:
+            // Constructs an empty set
+            TargetSet();
+
+            // Returns a set containing the default targets (vibrant, light vibrant, dark vibrant,
+            // muted, light muted and dark muted, with handles 0 to 5 in that order)
+            static TargetSet defaults();
+
+            // Adds the target to the set, returning its handle
+            // If an equal target has already been added its handle is returned instead
+            int add(const Target &);
+
+            // Returns the handle of the given target, or -1 if it isn't in the set
+            int find(const Target &) const;
+
+            // Returns the handle of the given default target, or -1 if it isn't in the set
+            int getDefaultHandle(Default) const;
+
+            // Removes all targets (handles which were given out are no longer valid)
+            void clear();
+
+            // Returns the number of targets in the set
+            size_t size() const;
+
+            // Returns the target with the given handle (as it was added)
+            const Target & get(int) const;
+
+            // Returns all of the targets in order of their handles
+            const std::vector<Target> & getTargets() const;
+
+            // Returns the normalized values of every target in order of their handles
+            const float * getScoringValues() const;
+    };
+};
+
+#endif
\ No newline at end of file
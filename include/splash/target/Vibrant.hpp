@@ -4,14 +4,8 @@
 #include "splash/target/Target.hpp"
 
 namespace Splash::Target {
-    // Inherits Target to invoke methods to create the static VIBRANT target
-    class Vibrant : public Target {
-        public:
-            Vibrant();
-    };
-
-    // Static instance
-    static Vibrant VIBRANT;
+    // Target matching vibrant colours
+    constexpr Target VIBRANT = Target({{MIN_VIBRANT_SATURATION, TARGET_VIBRANT_SATURATION, 1.0f}}, {{MIN_NORMAL_LUMA, TARGET_NORMAL_LUMA, MAX_NORMAL_LUMA}});
 };
 
 #endif
\ No newline at end of file
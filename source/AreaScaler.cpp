@@ -0,0 +1,133 @@
+#include "splash/AreaScaler.hpp"
+#include "splash/Simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Maximum value of a component when stored in linear light
+#define LINEAR_MAX 4095
+
+namespace Splash {
+    // Lookup tables used to average pixels in linear light
+    struct LinearTables {
+        // sRGB component -> linear value in [0, LINEAR_MAX]
+        uint16_t toLinear[256];
+        // Linear value -> sRGB component
+        uint8_t fromLinear[LINEAR_MAX + 1];
+
+        LinearTables() {
+            for (size_t i = 0; i < 256; i++) {
+                double c = i/255.0;
+                c = (c <= 0.04045 ? c/12.92 : std::pow((c + 0.055)/1.055, 2.4));
+                this->toLinear[i] = std::round(c * LINEAR_MAX);
+            }
+            for (size_t i = 0; i <= LINEAR_MAX; i++) {
+                double c = i/(double)LINEAR_MAX;
+                c = (c <= 0.0031308 ? c * 12.92 : (1.055 * std::pow(c, 1/2.4)) - 0.055);
+                this->fromLinear[i] = std::round(c * 255);
+            }
+        }
+    };
+
+    static const LinearTables & linearTables() {
+        static LinearTables tables;
+        return tables;
+    }
+
+    AreaScaler::AreaScaler() {
+        this->height = 0;
+        this->width = 0;
+        this->linear = false;
+    }
+
+    AreaScaler::AreaScaler(const BitmapView & view, size_t w, size_t h, bool lin) {
+        this->reset(view, w, h, lin);
+    }
+
+    void AreaScaler::reset(const BitmapView & view, size_t w, size_t h, bool lin) {
+        this->source = view;
+        this->height = h;
+        this->width = w;
+        this->linear = lin;
+
+        // Precompute the first source column covered by each scaled column
+        this->columns.resize(w + 1);
+        for (size_t x = 0; x <= w; x++) {
+            this->columns[x] = (w == 0 ? 0 : (x * view.getWidth())/w);
+        }
+
+        // Rows in other formats are converted into a buffer before averaging
+        if (view.getFormat() != PixelFormat::ARGB8888) {
+            this->converted.resize(view.getWidth());
+        } else {
+            this->converted.clear();
+        }
+        this->acc.resize(view.getWidth() * 4);
+    }
+
+    void AreaScaler::scaleRow(size_t y, size_t x, size_t w, Colour * dst) {
+        if (w == 0 || y >= this->height || x + w > this->width || this->source.getWidth() == 0 || this->source.getHeight() == 0) {
+            return;
+        }
+
+        // Source rows covered by this row (always at least one)
+        size_t y1 = (y * this->source.getHeight())/this->height;
+        size_t y2 = std::max(((y + 1) * this->source.getHeight())/this->height, y1 + 1);
+
+        // Source columns covered by the requested columns
+        size_t c1 = this->columns[x];
+        size_t c2 = std::max(this->columns[x + w], this->columns[x + w - 1] + 1);
+        size_t count = c2 - c1;
+
+        // Sum each column vertically
+        const LinearTables & tables = linearTables();
+        size_t bpp = bytesPerPixel(this->source.getFormat());
+        std::fill(this->acc.begin(), this->acc.begin() + (count * 4), 0);
+        for (size_t r = y1; r < y2; r++) {
+            const unsigned char * row = static_cast<const unsigned char *>(this->source.getRow(r)) + (c1 * bpp);
+            const Colour * src = reinterpret_cast<const Colour *>(row);
+            if (!this->converted.empty()) {
+                convertRow(row, this->source.getFormat(), count, this->converted.data());
+                src = this->converted.data();
+            }
+
+            if (this->linear) {
+                // Stored as (a, r, g, b) with colour components converted to linear light
+                for (size_t i = 0; i < count; i++) {
+                    this->acc[(i * 4)] += src[i].a();
+                    this->acc[(i * 4) + 1] += tables.toLinear[src[i].r()];
+                    this->acc[(i * 4) + 2] += tables.toLinear[src[i].g()];
+                    this->acc[(i * 4) + 3] += tables.toLinear[src[i].b()];
+                }
+            } else {
+                Simd::accumulateRow(src, count, this->acc.data());
+            }
+        }
+
+        // Now average the columns covered by each scaled pixel and write it out
+        for (size_t i = 0; i < w; i++) {
+            size_t x1 = this->columns[x + i];
+            size_t x2 = std::max(this->columns[x + i + 1], x1 + 1);
+            uint64_t area = (x2 - x1) * (y2 - y1);
+
+            uint64_t sums[4] = {0, 0, 0, 0};
+            for (size_t c = x1 - c1; c < x2 - c1; c++) {
+                sums[0] += this->acc[(c * 4)];
+                sums[1] += this->acc[(c * 4) + 1];
+                sums[2] += this->acc[(c * 4) + 2];
+                sums[3] += this->acc[(c * 4) + 3];
+            }
+
+            if (this->linear) {
+                dst[i] = Colour((sums[0] + area/2)/area, tables.fromLinear[(sums[1] + area/2)/area], tables.fromLinear[(sums[2] + area/2)/area], tables.fromLinear[(sums[3] + area/2)/area]);
+            } else {
+                // Accumulators are in the same order as the pixel's bytes
+                unsigned char bytes[4];
+                for (size_t j = 0; j < 4; j++) {
+                    bytes[j] = (sums[j] + area/2)/area;
+                }
+                std::memcpy(&dst[i], bytes, sizeof(bytes));
+            }
+        }
+    }
+};
\ No newline at end of file
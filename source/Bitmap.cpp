@@ -1,39 +1,63 @@
 #include "splash/Bitmap.hpp"
-#include <cmath>
+#include "splash/BitmapView.hpp"
+#include <algorithm>
+#include <cstring>
+
+// Rows are padded to a multiple of this many pixels (64 bytes)
+#define STRIDE_ALIGNMENT 16
 
 namespace Splash {
     static Colour COLOUR_WHITE = Colour(255, 255, 255, 255);
 
+    // Returns the stride to use for the given width
+    static size_t alignedStride(size_t w) {
+        return (w + STRIDE_ALIGNMENT - 1) & ~((size_t)STRIDE_ALIGNMENT - 1);
+    }
+
     Bitmap::Bitmap() {
         this->valid = false;
+        this->height = 0;
+        this->width = 0;
+        this->stride = 0;
     }
 
     Bitmap::Bitmap(size_t w, size_t h) {
         // Set dimensions
         this->height = h;
         this->width = w;
+        this->stride = alignedStride(w);
 
-        // Create 2D vector matching these dimensions
+        // Allocate a single buffer matching these dimensions
         // Fill with opaque white
-        for (size_t y = 0; y < h; y++) {
-            this->grid.push_back(std::vector<Colour>());
-            for (size_t x = 0; x < w; x++) {
-                this->grid[y].push_back(COLOUR_WHITE);
-            }
-        }
+        this->pixels.assign(this->stride * h, COLOUR_WHITE);
 
         this->valid = true;
     }
 
+    void Bitmap::resize(size_t w, size_t h) {
+        size_t newStride = alignedStride(w);
+        std::vector< Colour, AlignedAllocator<Colour> > newPixels(newStride * h, COLOUR_WHITE);
+
+        // Copy across the overlapping region row by row
+        size_t copyW = std::min(w, this->width);
+        size_t copyH = std::min(h, this->height);
+        for (size_t y = 0; y < copyH; y++) {
+            std::copy(this->pixels.begin() + y * this->stride, this->pixels.begin() + y * this->stride + copyW, newPixels.begin() + y * newStride);
+        }
+
+        this->pixels.swap(newPixels);
+        this->width = w;
+        this->height = h;
+        this->stride = newStride;
+    }
+
     bool Bitmap::isValid() const {
         return this->valid;
     }
 
     Colour Bitmap::getPixel(size_t x, size_t y) const {
-        if (y < this->grid.size()) {
-            if (x < this->grid[y].size()) {
-                return this->grid[y][x];
-            }
+        if (x < this->width && y < this->height) {
+            return this->pixels[y * this->stride + x];
         }
 
         return COLOUR_WHITE;
@@ -43,44 +67,97 @@ namespace Splash {
         std::vector<Colour> v;
 
         // Don't bother checking if requesting pixels outside of dimensions
-        if (x > this->grid.size() || y > this->grid[0].size()) {
+        if (x >= this->width || y >= this->height) {
             return v;
         }
 
-        // Ensure width and height are within bounds while checking
-        h = (h > this->grid.size()-y ? this->grid.size()-y : h);
-        for (size_t r = y; r < y+h; r++) {
-            w = (w > this->grid[r].size()-x ? this->grid[r].size()-x : w);
-            for (size_t c = x; c < x+w; c++) {
-                v.push_back(this->grid[r][c]);
-            }
+        // Ensure width and height are within bounds before copying
+        w = std::min(w, this->width - x);
+        h = std::min(h, this->height - y);
+        v.resize(w * h);
+        for (size_t r = 0; r < h; r++) {
+            const Colour * row = this->pixels.data() + (y + r) * this->stride + x;
+            std::copy(row, row + w, v.begin() + r * w);
         }
 
         return v;
     }
 
     void Bitmap::setPixel(Colour & c, size_t x, size_t y) {
-        if (y < this->grid.size()) {
-            if (x < this->grid[y].size()) {
-                this->grid[y][x] = c;
-            }
+        if (x < this->width && y < this->height) {
+            this->pixels[y * this->stride + x] = c;
         }
     }
 
     size_t Bitmap::setPixels(std::vector<Colour> & cols, size_t x, size_t y, size_t w, size_t h) {
-        size_t nextIdx = 0;
-        for (size_t r = x; r < this->grid.size(); r++) {
-            for (size_t c = y; c < this->grid[r].size(); c++) {
-                // Stop if at the end of the vector
-                if (nextIdx >= cols.size()) {
-                    return nextIdx;
-                }
-
-                this->grid[r][c] = cols[nextIdx];
-                nextIdx++;
+        // Clip the region to the bitmap
+        if (x >= this->width || y >= this->height) {
+            return 0;
+        }
+        size_t cw = std::min(w, this->width - x);
+        size_t ch = std::min(h, this->height - y);
+
+        // Source is treated as rows of w pixels
+        size_t used = 0;
+        for (size_t r = 0; r < ch; r++) {
+            size_t srcIdx = r * w;
+
+            // Stop if at the end of the vector
+            if (srcIdx >= cols.size()) {
+                break;
+            }
+
+            size_t count = std::min(cw, cols.size() - srcIdx);
+            std::copy(cols.begin() + srcIdx, cols.begin() + srcIdx + count, this->pixels.begin() + (y + r) * this->stride + x);
+            used += count;
+        }
+        return used;
+    }
+
+    size_t Bitmap::importRows(const Colour * src, size_t srcStride, size_t y, size_t rows) {
+        if (y >= this->height) {
+            return 0;
+        }
+        rows = std::min(rows, this->height - y);
+        if (rows == 0) {
+            return 0;
+        }
+
+        // Copy everything at once if the strides match
+        Colour * dst = this->pixels.data() + y * this->stride;
+        if (srcStride == this->stride) {
+            std::memcpy(dst, src, ((rows - 1) * this->stride + this->width) * sizeof(Colour));
+        } else {
+            for (size_t r = 0; r < rows; r++) {
+                std::memcpy(dst + r * this->stride, src + r * srcStride, this->width * sizeof(Colour));
             }
         }
-        return nextIdx;
+        return rows;
+    }
+
+    size_t Bitmap::exportRows(Colour * dst, size_t dstStride, size_t y, size_t rows) const {
+        if (y >= this->height) {
+            return 0;
+        }
+        rows = std::min(rows, this->height - y);
+
+        const Colour * src = this->pixels.data() + y * this->stride;
+        for (size_t r = 0; r < rows; r++) {
+            std::memcpy(dst + r * dstStride, src + r * this->stride, this->width * sizeof(Colour));
+        }
+        return rows;
+    }
+
+    Colour * Bitmap::data() {
+        return this->pixels.data();
+    }
+
+    const Colour * Bitmap::data() const {
+        return this->pixels.data();
+    }
+
+    size_t Bitmap::getStride() const {
+        return this->stride;
     }
 
     size_t Bitmap::getHeight() const {
@@ -92,64 +169,18 @@ namespace Splash {
     }
 
     void Bitmap::setHeight(size_t h) {
-        // Increase if new height is larger
-        while (this->grid.size() < h) {
-            std::vector<Colour> row;
-            for (size_t x = 0; x < this->width; x++) {
-                row.push_back(COLOUR_WHITE);
-            }
-            this->grid.push_back(row);
-        }
-
-        // Decrease if new height is smaller
-        while (this->grid.size() > h) {
-            this->grid.erase(this->grid.end() - 1);
-        }
-
+        // Rows are contiguous so only the end of the buffer changes
+        this->pixels.resize(this->stride * h, COLOUR_WHITE);
         this->height = h;
     }
 
     void Bitmap::setWidth(size_t w) {
-        // Increase if new width is larger
-        if (this->width < w) {
-            for (size_t r = 0; r < this->grid.size(); r++) {
-                while (this->grid[r].size() < w) {
-                    this->grid[r].push_back(COLOUR_WHITE);
-                }
-            }
-
-        // Decrease if new width is smaller
-        } else if (this->width > w) {
-            for (size_t r = 0; r < this->grid.size(); r++) {
-                while (this->grid[r].size() > w) {
-                    this->grid[r].erase(this->grid[r].end() - 1);
-                }
-            }
+        if (w != this->width) {
+            this->resize(w, this->height);
         }
-
-        this->width = w;
     }
 
-    Bitmap Bitmap::createScaledBitmap(size_t nw, size_t nh) const {
-        // Create new bitmap
-        Bitmap b = Bitmap(nw, nh);
-
-        // Use nearest neighbour to populate vector with colours
-        std::vector<Colour> pixels;
-        double px, py;
-        double xr = this->width/(double)b.getWidth();
-        double yr = this->height/(double)b.getHeight();
-        for (size_t y = 0; y < b.getHeight(); y++) {
-            for (size_t x = 0; x < b.getWidth(); x++) {
-                px = std::floor((double)x*xr);
-                py = std::floor((double)y*yr);
-                Colour c = this->grid[py][px];
-                pixels.push_back(Colour(c.a(), c.r(), c.g(), c.b()));
-            }
-        }
-
-        // Set bitmap pixels and return
-        b.setPixels(pixels, 0, 0, b.getWidth(), b.getHeight());
-        return b;
+    Bitmap Bitmap::createScaledBitmap(size_t nw, size_t nh, bool linear) const {
+        return BitmapView(*this).createScaledBitmap(nw, nh, linear);
     }
 };
\ No newline at end of file
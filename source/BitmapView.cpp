@@ -0,0 +1,99 @@
+#include "splash/AreaScaler.hpp"
+#include "splash/BitmapView.hpp"
+#include <algorithm>
+
+namespace Splash {
+    static Colour COLOUR_WHITE = Colour(255, 255, 255, 255);
+
+    BitmapView::BitmapView() {
+        this->pixels = nullptr;
+        this->height = 0;
+        this->width = 0;
+        this->stride = 0;
+        this->format = PixelFormat::ARGB8888;
+    }
+
+    BitmapView::BitmapView(const Colour * p, size_t w, size_t h, size_t s) {
+        this->pixels = reinterpret_cast<const unsigned char *>(p);
+        this->height = h;
+        this->width = w;
+        this->stride = s * sizeof(Colour);
+        this->format = PixelFormat::ARGB8888;
+    }
+
+    BitmapView::BitmapView(const void * p, size_t w, size_t h, size_t s, PixelFormat f) {
+        this->pixels = static_cast<const unsigned char *>(p);
+        this->height = h;
+        this->width = w;
+        this->stride = s;
+        this->format = f;
+    }
+
+    BitmapView::BitmapView(const Bitmap & b) {
+        this->pixels = (b.isValid() ? reinterpret_cast<const unsigned char *>(b.data()) : nullptr);
+        this->height = b.getHeight();
+        this->width = b.getWidth();
+        this->stride = b.getStride() * sizeof(Colour);
+        this->format = PixelFormat::ARGB8888;
+    }
+
+    bool BitmapView::isValid() const {
+        return (this->pixels != nullptr);
+    }
+
+    const void * BitmapView::getRow(size_t y) const {
+        return this->pixels + (y * this->stride);
+    }
+
+    Colour BitmapView::getPixel(size_t x, size_t y) const {
+        if (x < this->width && y < this->height) {
+            Colour c;
+            convertRow(this->pixels + (y * this->stride) + (x * bytesPerPixel(this->format)), this->format, 1, &c);
+            return c;
+        }
+
+        return COLOUR_WHITE;
+    }
+
+    BitmapView BitmapView::crop(size_t x, size_t y, size_t w, size_t h) const {
+        // Clip to boundaries
+        x = std::min(x, this->width);
+        y = std::min(y, this->height);
+        w = std::min(w, this->width - x);
+        h = std::min(h, this->height - y);
+
+        BitmapView view = *this;
+        if (this->pixels != nullptr) {
+            view.pixels = this->pixels + (y * this->stride) + (x * bytesPerPixel(this->format));
+        }
+        view.width = w;
+        view.height = h;
+        return view;
+    }
+
+    size_t BitmapView::getHeight() const {
+        return this->height;
+    }
+
+    size_t BitmapView::getWidth() const {
+        return this->width;
+    }
+
+    size_t BitmapView::getStride() const {
+        return this->stride;
+    }
+
+    PixelFormat BitmapView::getFormat() const {
+        return this->format;
+    }
+
+    Bitmap BitmapView::createScaledBitmap(size_t nw, size_t nh, bool linear) const {
+        // Create new bitmap and write each scaled row straight into it
+        Bitmap b = Bitmap(nw, nh);
+        AreaScaler scaler = AreaScaler(*this, nw, nh, linear);
+        for (size_t y = 0; y < nh; y++) {
+            scaler.scaleRow(y, 0, nw, b.data() + (y * b.getStride()));
+        }
+        return b;
+    }
+};
\ No newline at end of file
@@ -1,70 +1,39 @@
 #include "splash/ColourCutQuantizer.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/QuantizerWorkspace.hpp"
 #include <algorithm>
 #include <cmath>
-#include <limits>
 
-// Constants
-#define QUANTIZE_WORD_WIDTH 5
-#define QUANTIZE_WORD_MASK ((1 << QUANTIZE_WORD_WIDTH) - 1)
+// Minimum number of colours in the boxes split by each thread
+#define MIN_COLOURS_PER_THREAD 4096
 
 namespace Splash {
-    ColourCutQuantizer::Vbox::Vbox(ColourCutQuantizer * q, size_t lower, size_t upper) {
-        this->ccq = q;
+    ColourCutQuantizer::Vbox::Vbox(size_t lower, size_t upper) {
+        static_assert(sizeof(Vbox) == 16, "Vbox records should be 16 bytes");
+
         this->lowerIndex = lower;
         this->upperIndex = upper;
-        this->fitBox();
-    }
 
-    void ColourCutQuantizer::Vbox::fitBox() {
-        // Reset min and max to opposite limits
-        this->minR = std::numeric_limits<int>::max();
-        this->minG = this->minR;
-        this->minB = this->minR;
-        this->maxR = std::numeric_limits<int>::min();
-        this->maxG = this->maxR;
-        this->maxB = this->maxR;
-
-        // Perform some magic
-        this->population = 0;
-        for (size_t idx = this->lowerIndex; idx <= this->upperIndex; idx++) {
-            int col = this->ccq->colours[idx];
-            this->population += this->ccq->histogram[col];
-
-            // Get quantized values
-            int r = quantizedComponent(col, Dimension::Red);
-            int g = quantizedComponent(col, Dimension::Green);
-            int b = quantizedComponent(col, Dimension::Blue);
-            if (r > this->maxR) {
-                this->maxR = r;
-            }
-            if (r < this->minR) {
-                this->minR = r;
-            }
-            if (g > this->maxG) {
-                this->maxG = g;
-            }
-            if (g < this->minG) {
-                this->minG = g;
-            }
-            if (b > this->maxB) {
-                this->maxB = b;
-            }
-            if (b < this->minB) {
-                this->minB = b;
-            }
-        }
+        // Set min and max to opposite limits (of any word width)
+        this->minR = UINT8_MAX;
+        this->minG = UINT8_MAX;
+        this->minB = UINT8_MAX;
+        this->maxR = 0;
+        this->maxG = 0;
+        this->maxB = 0;
     }
 
-    ColourCutQuantizer::Vbox ColourCutQuantizer::Vbox::splitBox() {
-        // The Java library throws an exception here, we're going to assume it can be split
-        size_t splitPoint = this->findSplitPoint();
-
-        // Create new Vbox using upper half and adjust this box's index
-        Vbox newBox = Vbox(this->ccq, splitPoint + 1, this->upperIndex);
-        this->upperIndex = splitPoint;
-        this->fitBox();
-
-        return newBox;
+    template <int W>
+    void ColourCutQuantizer::Vbox::include(int col) {
+        uint8_t r = quantizedComponent<W>(col, Dimension::Red);
+        uint8_t g = quantizedComponent<W>(col, Dimension::Green);
+        uint8_t b = quantizedComponent<W>(col, Dimension::Blue);
+        this->minR = std::min(this->minR, r);
+        this->maxR = std::max(this->maxR, r);
+        this->minG = std::min(this->minG, g);
+        this->maxG = std::max(this->maxG, g);
+        this->minB = std::min(this->minB, b);
+        this->maxB = std::max(this->maxB, b);
     }
 
     Dimension ColourCutQuantizer::Vbox::getLongestColourDimension() const {
@@ -83,81 +52,24 @@ namespace Splash {
         }
     }
 
-    size_t ColourCutQuantizer::Vbox::findSplitPoint() {
-        // Get longest dimension and copy of colours vector
-        Dimension longD = this->getLongestColourDimension();
-
-        // Modify each colour so it's most significant is the desired dimension
-        this->modifySignificantOctet(this->ccq->colours, longD, this->lowerIndex, this->upperIndex);
-        // Sort colours based on longest colour dimension
-        std::stable_sort(this->ccq->colours.begin() + this->lowerIndex, this->ccq->colours.begin() + this->upperIndex + 1);
-        // Now revert back to RGB format
-        this->modifySignificantOctet(this->ccq->colours, longD, this->lowerIndex, this->upperIndex);
-
-        // Now find split point
-        int count = 0;
-        int midPoint = this->population/2;
-        for (size_t i = this->lowerIndex; i <= this->upperIndex; i++) {
-            count += this->ccq->histogram[this->ccq->colours[i]];
-            if (count >= midPoint) {
-                return std::min(this->upperIndex - 1, i);
-            }
-        }
-
-        return this->lowerIndex;
-    }
-
-    Swatch ColourCutQuantizer::Vbox::getAverageColour() const {
-        int redS = 0;
-        int grnS = 0;
-        int bluS = 0;
-        int totalPop = 0;
-
-        // Sum up all colours
-        for (size_t i = this->lowerIndex; i <= this->upperIndex; i++) {
-            int col = this->ccq->colours[i];
-            int pop = this->ccq->histogram[col];
-
-            totalPop += pop;
-            redS += pop * quantizedComponent(col, Dimension::Red);
-            grnS += pop * quantizedComponent(col, Dimension::Green);
-            bluS += pop * quantizedComponent(col, Dimension::Blue);
-        }
-
-        // Calculate means
-        int redM = std::round(redS/(float)totalPop);
-        int grnM = std::round(grnS/(float)totalPop);
-        int bluM = std::round(bluS/(float)totalPop);
-
-        // Create and return Swatch
-        Colour c = Colour();
-        int raw = approximateToRGB888(redM, grnM, bluM);
-        c.setRaw(raw);
-        return Swatch(c, totalPop);
-    }
-
-    void ColourCutQuantizer::Vbox::modifySignificantOctet(std::vector<int> & cols, Dimension dim, size_t lower, size_t upper) {
+    template <int W>
+    int ColourCutQuantizer::Vbox::splitKey(int col, Dimension dim) {
         switch (dim) {
             case Dimension::Red:
-                // Already RGB, just return
-                break;
+                // Already RGB
+                return col;
 
             case Dimension::Green:
                 // Swap R and G
-                for (size_t i = lower; i <= upper; i++) {
-                    int col = cols[i];
-                    cols[i] = (quantizedComponent(col, Dimension::Green) << (QUANTIZE_WORD_WIDTH + QUANTIZE_WORD_WIDTH)) | (quantizedComponent(col, Dimension::Red) << QUANTIZE_WORD_WIDTH) | quantizedComponent(col, Dimension::Blue);
-                }
-                break;
+                return (quantizedComponent<W>(col, Dimension::Green) << (W + W)) | (quantizedComponent<W>(col, Dimension::Red) << W) | quantizedComponent<W>(col, Dimension::Blue);
 
             case Dimension::Blue:
                 // Swap R and B
-                for (size_t i = lower; i <= upper; i++) {
-                    int col = cols[i];
-                    cols[i] = (quantizedComponent(col, Dimension::Blue) << (QUANTIZE_WORD_WIDTH + QUANTIZE_WORD_WIDTH)) | (quantizedComponent(col, Dimension::Green) << QUANTIZE_WORD_WIDTH) | quantizedComponent(col, Dimension::Red);
-                }
-                break;
+                return (quantizedComponent<W>(col, Dimension::Blue) << (W + W)) | (quantizedComponent<W>(col, Dimension::Green) << W) | quantizedComponent<W>(col, Dimension::Red);
         }
+
+        // Never reached
+        return col;
     }
 
     int ColourCutQuantizer::Vbox::getVolume() const {
@@ -172,112 +84,254 @@ namespace Splash {
         return (1 + this->upperIndex - this->lowerIndex);
     }
 
-    // Comparator for priority queue of Vboxes
-    bool ColourCutQuantizer::VBOX_COMP(Vbox & lhs, Vbox & rhs) {
+    // Comparator for heap of Vboxes
+    bool ColourCutQuantizer::VBOX_COMP(const Vbox & lhs, const Vbox & rhs) {
         return lhs.getVolume() < rhs.getVolume();
     };
 
-    ColourCutQuantizer::ColourCutQuantizer(std::vector<Colour> & pixels, int maxColours, std::vector<Filter::Filter *> & fs) {
+    ColourCutQuantizer::ColourCutQuantizer(std::vector<Colour> & pixels, int maxColours, std::vector<Filter::Filter *> & fs) : ColourCutQuantizer(BitmapView(pixels.data(), pixels.size(), 1, pixels.size()), maxColours, fs) {
+
+    }
+
+    ColourCutQuantizer::ColourCutQuantizer(const BitmapView & pixels, int maxColours, std::vector<Filter::Filter *> & fs, size_t threads, QuantizerWorkspace * ws, int wordWidth) : workspace(ws != nullptr ? *ws : QuantizerWorkspace::local()), colours(workspace.colours), histogram(workspace.histogram) {
         this->filters = fs;
+        this->threads = threads;
+        this->workspace.setWordWidth(wordWidth);
 
-        // First convert from Colours to raw ints
-        std::vector<int> intPixels;
-        for (size_t i = 0; i < pixels.size(); i++) {
-            intPixels.push_back(pixels[i].raw());
-        }
+        // Count occurrences of quantized colours, reading each row in place
+        Histogram::count(pixels, threads, this->workspace);
 
-        // Count occurrences of quantized colours
-        this->histogram.resize(1 << (QUANTIZE_WORD_WIDTH * 3), 0);
-        for (size_t i = 0; i < intPixels.size(); i++) {
-            int quantizedColour = quantizeFromRGB888(intPixels[i]);
-            intPixels[i] = quantizedColour;
-            this->histogram[quantizedColour]++;
-        }
+        this->quantizeHistogram(maxColours);
+    }
 
-        // Count distinct colours
-        int count = 0;
-        for (size_t i = 0; i < this->histogram.size(); i++) {
-            if (this->histogram[i] > 0 && this->shouldIgnoreColour565(i)) {
-                // Set population to zero if it should be ignored
-                this->histogram[i] = 0;
-            }
+    ColourCutQuantizer::ColourCutQuantizer(const BitmapView & pixels, size_t width, size_t height, int maxColours, std::vector<Filter::Filter *> & fs, size_t threads, QuantizerWorkspace * ws, int wordWidth) : workspace(ws != nullptr ? *ws : QuantizerWorkspace::local()), colours(workspace.colours), histogram(workspace.histogram) {
+        this->filters = fs;
+        this->threads = threads;
+        this->workspace.setWordWidth(wordWidth);
 
-            if (this->histogram[i] > 0) {
-                count++;
-            }
-        }
+        // Count occurrences of quantized colours while scaling
+        Histogram::countScaled(pixels, width, height, threads, this->workspace);
 
-        // Now create array consisting of distinct colours
-        this->colours.resize(count, 0);
-        int index = 0;
-        for (size_t i = 0; i < this->histogram.size(); i++) {
-            if (this->histogram[i] > 0) {
-                this->colours[index] = i;
-                index++;
-            }
+        this->quantizeHistogram(maxColours);
+    }
+
+    ColourCutQuantizer::ColourCutQuantizer(QuantizerWorkspace & ws, int maxColours, const std::shared_ptr<const Filter::FilterMask> & m, size_t threads) : workspace(ws), colours(workspace.colours), histogram(workspace.histogram) {
+        this->mask = m;
+        this->threads = threads;
+        this->reduceColours(maxColours);
+    }
+
+    ColourCutQuantizer::ColourCutQuantizer(QuantizerWorkspace & ws, const std::shared_ptr<const Filter::FilterMask> & m, size_t threads) : workspace(ws), colours(workspace.colours), histogram(workspace.histogram) {
+        this->mask = m;
+        this->threads = threads;
+    }
+
+    void ColourCutQuantizer::quantizeHistogram(int maxColours) {
+        // Find which colours occur, and keep those which the filters allow
+        this->mask = Filter::FilterMask::get(this->filters, this->workspace.getWordWidth());
+        Histogram::filter(this->workspace, *this->mask);
+        this->reduceColours(maxColours);
+
+        // Leave the workspace ready for the next quantizer
+        Histogram::clear(this->workspace);
+    }
+
+    void ColourCutQuantizer::reduceColours(int maxColours) {
+        // Reduce the colours using the constants for the word width
+        switch (this->workspace.getWordWidth()) {
+            case 4:
+                this->quantizedColours = this->quantizeColours<4>(maxColours);
+                break;
+
+            case 5:
+                this->quantizedColours = this->quantizeColours<5>(maxColours);
+                break;
+
+            case 6:
+                this->quantizedColours = this->quantizeColours<6>(maxColours);
+                break;
         }
+    }
 
+    template <int W>
+    std::vector<Swatch> ColourCutQuantizer::quantizeColours(int maxColours) {
         // If the image has fewer colours than requested, use these colours
-        if (count <= maxColours) {
+        if ((int)this->colours.size() <= maxColours) {
+            std::vector<Swatch> swatches;
             for (size_t i = 0; i < this->colours.size(); i++) {
                 int val = this->colours[i];
-                int raw = approximateToRGB888(val);
+                int raw = approximateToRGB888<W>(val);
                 Colour c = Colour();
                 c.setRaw(raw);
-                this->quantizedColours.push_back(Swatch(c, this->histogram[val]));
+                swatches.push_back(Swatch(c, this->histogram[val]));
             }
+            return swatches;
+        }
 
         // Otherwise use quantization to reduce number of colours
-        } else {
-            this->quantizedColours = quantizePixels(maxColours);
-        }
+        return this->quantizePixels<W>(maxColours);
     }
 
     std::vector<Swatch> ColourCutQuantizer::getQuantizedColours() {
         return this->quantizedColours;
     }
 
+    template <int W>
     std::vector<Swatch> ColourCutQuantizer::quantizePixels(int maxColours) {
-        // Create the priority queue which is sorted by volume descending
-        std::priority_queue<Vbox, std::vector<Vbox>, decltype(&VBOX_COMP)> pq(VBOX_COMP);
+        // Create the heap which is sorted by volume descending. As there is never more than
+        // maxColours boxes it's allocated once up front (and kept in the workspace).
+        std::vector<Vbox> & heap = this->workspace.boxes;
+        heap.clear();
+        heap.reserve(std::max(maxColours, 1));
 
-        // To start, place a box on the queue which contains all of the colours
-        pq.push(Vbox(this, 0, this->colours.size() - 1));
+        // To start, place a box on the heap which contains all of the colours
+        Vbox vbox = Vbox(0, this->colours.size() - 1);
+        this->fitBox<W>(vbox);
+        heap.push_back(vbox);
 
         // Now recursively split boxes until we have reached maxColours or there are
         // no more boxes to split
-        this->splitBoxes(pq, maxColours);
+        this->splitBoxes<W>(heap, maxColours);
+
+        // Return average colours of each box
+        return this->generateAverageColours<W>(heap);
+    }
 
-        // Need to convert priority queue to vector at this point
-        std::vector<Vbox> vec;
-        while (!pq.empty()) {
-            vec.push_back(pq.top());
-            pq.pop();
+    template <int W>
+    void ColourCutQuantizer::fitBox(Vbox & vbox) const {
+        vbox = Vbox(vbox.lowerIndex, vbox.upperIndex);
+        for (size_t i = vbox.lowerIndex; i <= vbox.upperIndex; i++) {
+            vbox.include<W>(this->colours[i]);
         }
+    }
 
-        // Return average colours of each box
-        return this->generateAverageColours(vec);
+    template <int W>
+    ColourCutQuantizer::Vbox ColourCutQuantizer::splitBox(Vbox & vbox) {
+        // Get longest dimension
+        Dimension longD = vbox.getLongestColourDimension();
+
+        // Colours are split where the population reaches the midpoint when they are ordered by a key
+        // with the longest dimension as the most significant component. Rather than sorting, the key
+        // at the midpoint is found one component at a time by counting the population of each value.
+        uint32_t * cols = this->colours.data();
+        const int64_t * hist = this->histogram.data();
+        int64_t remaining = 0;
+        int target = 0;
+        size_t below = 0;
+        for (int level = 0; level < 3; level++) {
+            int shift = W * (2 - level);
+            int64_t pops[1 << W] = {0};
+            size_t nums[1 << W] = {0};
+
+            // Only colours matching the components found so far are counted
+            for (size_t i = vbox.lowerIndex; i <= vbox.upperIndex; i++) {
+                int key = Vbox::splitKey<W>(cols[i], longD);
+                if ((key >> (shift + W)) == target) {
+                    int bucket = (key >> shift) & Histogram::Precision<W>::mask;
+                    pops[bucket] += hist[cols[i]];
+                    nums[bucket]++;
+                }
+            }
+
+            // The first pass covers the whole box, giving its population
+            if (level == 0) {
+                for (size_t i = 0; i < (1 << W); i++) {
+                    remaining += pops[i];
+                }
+                remaining /= 2;
+            }
+
+            // Find the value at which the population reaches the midpoint
+            int bucket = 0;
+            while (pops[bucket] < remaining) {
+                remaining -= pops[bucket];
+                below += nums[bucket];
+                bucket++;
+            }
+            target = (target << W) | bucket;
+        }
+
+        // Colours are unique so exactly one has the target key. It joins the lower half,
+        // unless that would leave the upper half empty.
+        size_t lowerCount = std::min(below + 1, static_cast<size_t>(vbox.getColourCount() - 1));
+        bool includeTarget = (lowerCount > below);
+
+        // Partition the colours around the target, fitting each half's bounds as they're seen
+        Vbox lower = Vbox(vbox.lowerIndex, vbox.lowerIndex + lowerCount - 1);
+        Vbox upper = Vbox(vbox.lowerIndex + lowerCount, vbox.upperIndex);
+        size_t next = vbox.lowerIndex;
+        for (size_t i = vbox.lowerIndex; i <= vbox.upperIndex; i++) {
+            uint32_t col = cols[i];
+            int key = Vbox::splitKey<W>(col, longD);
+            if (key < target || (includeTarget && key == target)) {
+                lower.include<W>(col);
+                std::swap(cols[i], cols[next]);
+                next++;
+            } else {
+                upper.include<W>(col);
+            }
+        }
+
+        vbox = lower;
+        return upper;
     }
 
-    void ColourCutQuantizer::splitBoxes(std::priority_queue<Vbox, std::vector<Vbox>, decltype(&VBOX_COMP)> & queue, int maxSize) {
-        while ((int)queue.size() < maxSize) {
+    template <int W>
+    void ColourCutQuantizer::splitBoxes(std::vector<Vbox> & heap, int maxSize, std::vector<Split> * history) {
+        std::vector<Split> & splits = this->workspace.splits;
+        splits.clear();
+
+        // The boxes always hold every colour between them, so if there aren't enough colours for
+        // two threads there's no point looking for boxes to split ahead
+        size_t colours = 0;
+        for (size_t i = 0; i < heap.size(); i++) {
+            colours += heap[i].getColourCount();
+        }
+        const bool ahead = (std::min(this->threads, colours/MIN_COLOURS_PER_THREAD) > 1);
+
+        while ((int)heap.size() < maxSize) {
             // Return if no more boxes to split
-            if (queue.empty()) {
+            if (heap.empty()) {
                 return;
             }
 
-            // Print queue
-            std::priority_queue<Vbox, std::vector<Vbox>, decltype(&VBOX_COMP)> copy = queue;
-            while (!copy.empty()) {
-                copy.pop();
-            }
-
             // Otherwise get top box and split if possible
-            Vbox vbox = queue.top();
-            queue.pop();
+            std::pop_heap(heap.begin(), heap.end(), VBOX_COMP);
+            Vbox vbox = heap.back();
+            heap.pop_back();
             if (vbox.canSplit()) {
-                queue.push(vbox.splitBox());
-                queue.push(vbox);
+                // The halves only depend on which colours are in the box, so splitting ahead of time on
+                // other threads gives exactly the same boxes, which are added in the same order
+                Vbox box = vbox;
+                Vbox upper = vbox;
+                size_t i = 0;
+                while (i < splits.size() && (splits[i].box.lowerIndex != vbox.lowerIndex || splits[i].box.upperIndex != vbox.upperIndex)) {
+                    i++;
+                }
+                if (i == splits.size() && ahead) {
+                    this->splitAhead<W>(vbox, heap, maxSize - static_cast<int>(heap.size()) - 2);
+                    i = splits.size() - 1;
+                    while (splits[i].box.lowerIndex != vbox.lowerIndex || splits[i].box.upperIndex != vbox.upperIndex) {
+                        i--;
+                    }
+                }
+
+                if (i < splits.size()) {
+                    vbox = splits[i].lower;
+                    upper = splits[i].upper;
+                    splits[i] = splits.back();
+                    splits.pop_back();
+                } else {
+                    upper = this->splitBox<W>(vbox);
+                }
+                if (history != nullptr) {
+                    history->push_back(Split{box, vbox, upper});
+                }
+
+                heap.push_back(upper);
+                std::push_heap(heap.begin(), heap.end(), VBOX_COMP);
+                heap.push_back(vbox);
+                std::push_heap(heap.begin(), heap.end(), VBOX_COMP);
 
             // If we can't split just return
             } else {
@@ -286,82 +340,149 @@ namespace Splash {
         }
     }
 
-    std::vector<Swatch> ColourCutQuantizer::generateAverageColours(std::vector<Vbox> & vboxes) {
-        std::vector<Swatch> swatches;
-        for (size_t i = 0; i < vboxes.size(); i++) {
-            Swatch swatch = vboxes[i].getAverageColour();
+    template <int W>
+    void ColourCutQuantizer::splitAhead(const Vbox & vbox, const std::vector<Vbox> & heap, int others) {
+        // Take the largest boxes which could be split after this one (at most one per remaining
+        // split). Boxes which end up not being split are left with their colours reordered, which
+        // doesn't change anything as only the set of colours in a box matters.
+        std::vector<Vbox> boxes = {vbox};
+        std::vector<Vbox> candidates;
+        for (size_t i = 0; i < heap.size(); i++) {
+            if (heap[i].canSplit()) {
+                candidates.push_back(heap[i]);
+            }
+        }
+        size_t count = std::min(candidates.size(), static_cast<size_t>(std::max(others, 0)));
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [](const Vbox & a, const Vbox & b) {
+            return VBOX_COMP(b, a);
+        });
+        boxes.insert(boxes.end(), candidates.begin(), candidates.begin() + count);
+
+        // Skip ones which have already been split
+        std::vector<Split> & splits = this->workspace.splits;
+        std::vector<Vbox> pending;
+        size_t total = 0;
+        for (size_t i = 0; i < boxes.size(); i++) {
+            bool done = false;
+            for (size_t j = 0; j < splits.size() && !done; j++) {
+                done = (splits[j].box.lowerIndex == boxes[i].lowerIndex && splits[j].box.upperIndex == boxes[i].upperIndex);
+            }
+            if (!done) {
+                pending.push_back(boxes[i]);
+                total += boxes[i].getColourCount();
+            }
+        }
 
-            // As the colour is averaged it may not be a colour we want
-            if (!this->shouldIgnoreColour888(swatch.getColour().raw())) {
-                swatches.push_back(swatch);
+        // Don't bother with threads if there isn't much work to go around
+        size_t shards = std::min(std::min(this->threads, total/MIN_COLOURS_PER_THREAD), pending.size());
+        if (shards <= 1) {
+            pending.erase(pending.begin() + 1, pending.end());
+            shards = 1;
+        }
+
+        // Hand the largest boxes out first, each to the least busy thread
+        std::vector< std::vector<Split> > work(shards);
+        std::vector<size_t> load(shards, 0);
+        std::sort(pending.begin(), pending.end(), [](const Vbox & a, const Vbox & b) {
+            return a.getColourCount() > b.getColourCount();
+        });
+        for (size_t i = 0; i < pending.size(); i++) {
+            size_t shard = std::min_element(load.begin(), load.end()) - load.begin();
+            work[shard].push_back(Split{pending[i], pending[i], pending[i]});
+            load[shard] += pending[i].getColourCount();
+        }
+
+        // The workspace's threads are reused, as this is called many times while quantizing
+        this->workspace.workers.run(shards, [this, &work](size_t shard) {
+            std::vector<Split> & list = work[shard];
+            for (size_t i = 0; i < list.size(); i++) {
+                list[i].upper = this->splitBox<W>(list[i].lower);
             }
+        });
+        for (size_t i = 0; i < shards; i++) {
+            splits.insert(splits.end(), work[i].begin(), work[i].end());
         }
-        return swatches;
     }
 
-    bool ColourCutQuantizer::shouldIgnoreColour565(int c565) {
-        // Convert quantized value (RGB565) to RGB888 before checking
-        int c888 = approximateToRGB888(c565);
-        return this->shouldIgnoreColour888(c888);
-    }
+    template <int W>
+    Swatch ColourCutQuantizer::getAverageColour(const Vbox & vbox) const {
+        // Sums are 64-bit as full resolution images can have billions of pixels in a box
+        int64_t redS = 0;
+        int64_t grnS = 0;
+        int64_t bluS = 0;
+        int64_t totalPop = 0;
 
-    bool ColourCutQuantizer::shouldIgnoreColour888(int c888) {
-        // Convert to colour object
-        Colour c = Colour();
-        c.setRaw(c888);
+        // Sum up all colours
+        for (size_t i = vbox.lowerIndex; i <= vbox.upperIndex; i++) {
+            int col = this->colours[i];
+            int64_t pop = this->histogram[col];
 
-        // Now check colour against each filter
-        if (this->filters.size() > 0) {
-            for (size_t i = 0; i < this->filters.size(); i++) {
-                if (!this->filters[i]->isAllowed(c)) {
-                    return true;
-                }
-            }
+            totalPop += pop;
+            redS += pop * quantizedComponent<W>(col, Dimension::Red);
+            grnS += pop * quantizedComponent<W>(col, Dimension::Green);
+            bluS += pop * quantizedComponent<W>(col, Dimension::Blue);
         }
 
-        return false;
-    }
+        // Calculate means
+        int redM = std::round(redS/(float)totalPop);
+        int grnM = std::round(grnS/(float)totalPop);
+        int bluM = std::round(bluS/(float)totalPop);
 
-    int ColourCutQuantizer::quantizeFromRGB888(int c888) {
-        // Create colour object for easy access to components
+        // Create and return Swatch
         Colour c = Colour();
-        c.setRaw(c888);
+        int raw = approximateToRGB888<W>(redM, grnM, bluM);
+        c.setRaw(raw);
+        return Swatch(c, totalPop);
+    }
 
-        // Calculate values
-        int r = modifyWordWidth(c.r(), 8, QUANTIZE_WORD_WIDTH);
-        int g = modifyWordWidth(c.g(), 8, QUANTIZE_WORD_WIDTH);
-        int b = modifyWordWidth(c.b(), 8, QUANTIZE_WORD_WIDTH);
+    template <int W>
+    std::vector<Swatch> ColourCutQuantizer::generateAverageColours(std::vector<Vbox> & heap) {
+        // Boxes are taken from the heap in order of volume (largest first)
+        std::vector<Swatch> swatches;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), VBOX_COMP);
+            Swatch swatch = this->getAverageColour<W>(heap.back());
+            heap.pop_back();
 
-        // Shift bits and return
-        return (r << (QUANTIZE_WORD_WIDTH + QUANTIZE_WORD_WIDTH) | g << QUANTIZE_WORD_WIDTH | b);
+            // As the colour is averaged it may not be a colour we want
+            // Averages are formed from quantized components, so can be checked using the mask
+            Colour c = swatch.getColour();
+            if (this->mask->isAllowed(Histogram::quantize(c, W))) {
+                swatches.push_back(swatch);
+            }
+        }
+        return swatches;
     }
 
+    template <int W>
     int ColourCutQuantizer::approximateToRGB888(int r, int g, int b) {
-        int ar = modifyWordWidth(r, QUANTIZE_WORD_WIDTH, 8);
-        int ag = modifyWordWidth(g, QUANTIZE_WORD_WIDTH, 8);
-        int ab = modifyWordWidth(b, QUANTIZE_WORD_WIDTH, 8);
+        int ar = modifyWordWidth(r, W, 8);
+        int ag = modifyWordWidth(g, W, 8);
+        int ab = modifyWordWidth(b, W, 8);
 
         // Use colour object to convert
         Colour c = Colour(255, ar, ag, ab);
         return c.raw();
     }
 
+    template <int W>
     int ColourCutQuantizer::approximateToRGB888(int c565) {
-        return approximateToRGB888(quantizedComponent(c565, Dimension::Red), quantizedComponent(c565, Dimension::Green), quantizedComponent(c565, Dimension::Blue));
+        return approximateToRGB888<W>(quantizedComponent<W>(c565, Dimension::Red), quantizedComponent<W>(c565, Dimension::Green), quantizedComponent<W>(c565, Dimension::Blue));
     }
 
+    template <int W>
     int ColourCutQuantizer::quantizedComponent(int c, Dimension d) {
         switch (d) {
             case Dimension::Red:
-                return ((c >> (QUANTIZE_WORD_WIDTH + QUANTIZE_WORD_WIDTH)) & QUANTIZE_WORD_MASK);
+                return Histogram::Precision<W>::component(c, 0);
                 break;
 
             case Dimension::Green:
-                return ((c >> (QUANTIZE_WORD_WIDTH)) & QUANTIZE_WORD_MASK);
+                return Histogram::Precision<W>::component(c, 1);
                 break;
 
             case Dimension::Blue:
-                return (c & QUANTIZE_WORD_MASK);
+                return Histogram::Precision<W>::component(c, 2);
                 break;
         }
 
@@ -383,4 +504,23 @@ namespace Splash {
 
         return ret & ((1 << to) - 1);
     }
+
+    // Components can be requested for each supported word width
+    template int ColourCutQuantizer::quantizedComponent<4>(int, Dimension);
+    template int ColourCutQuantizer::quantizedComponent<5>(int, Dimension);
+    template int ColourCutQuantizer::quantizedComponent<6>(int, Dimension);
+
+    // Used by SplitTree to split boxes itself
+    template void ColourCutQuantizer::fitBox<4>(Vbox &) const;
+    template void ColourCutQuantizer::splitBoxes<4>(std::vector<Vbox> &, int, std::vector<Split> *);
+    template Swatch ColourCutQuantizer::getAverageColour<4>(const Vbox &) const;
+    template int ColourCutQuantizer::approximateToRGB888<4>(int);
+    template void ColourCutQuantizer::fitBox<5>(Vbox &) const;
+    template void ColourCutQuantizer::splitBoxes<5>(std::vector<Vbox> &, int, std::vector<Split> *);
+    template Swatch ColourCutQuantizer::getAverageColour<5>(const Vbox &) const;
+    template int ColourCutQuantizer::approximateToRGB888<5>(int);
+    template void ColourCutQuantizer::fitBox<6>(Vbox &) const;
+    template void ColourCutQuantizer::splitBoxes<6>(std::vector<Vbox> &, int, std::vector<Split> *);
+    template Swatch ColourCutQuantizer::getAverageColour<6>(const Vbox &) const;
+    template int ColourCutQuantizer::approximateToRGB888<6>(int);
 };
\ No newline at end of file
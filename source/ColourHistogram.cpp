@@ -0,0 +1,217 @@
+#include "splash/ColourHistogram.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include <algorithm>
+#include <limits>
+
+// Bytes at the start of a serialized histogram, followed by the version
+#define BLOB_MAGIC "SPLH"
+#define BLOB_MAGIC_SIZE 4
+#define BLOB_VERSION 1
+
+namespace Splash {
+    // Appends the value to the blob using seven bits per byte (the top bit is set if more follow)
+    static void writeVarint(std::vector<uint8_t> & blob, uint64_t value) {
+        while (value >= 0x80) {
+            blob.push_back((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        blob.push_back(value);
+    }
+
+    // Reads a value written by writeVarint() at the given position, advancing it
+    // Returns false if the blob ends first or the value doesn't fit in 64 bits
+    static bool readVarint(const std::vector<uint8_t> & blob, size_t & pos, uint64_t & value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= blob.size()) {
+                return false;
+            }
+            uint8_t byte = blob[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ColourHistogram::ColourHistogram(int width) {
+        this->wordWidth = std::min(std::max(width, Histogram::MIN_WORD_WIDTH), Histogram::MAX_WORD_WIDTH);
+    }
+
+    ColourHistogram::ColourHistogram(const BitmapView & pixels, size_t threads, int width) : ColourHistogram(width) {
+        QuantizerWorkspace & ws = QuantizerWorkspace::local();
+        ws.setWordWidth(this->wordWidth);
+        Histogram::count(pixels, threads, ws);
+
+        // List every occupied bin (nothing is filtered out) and copy their counts
+        std::vector<Filter::Filter *> none;
+        Histogram::filter(ws, *Filter::FilterMask::get(none, this->wordWidth));
+        this->bins = ws.colours;
+        this->counts.resize(this->bins.size());
+        for (size_t i = 0; i < this->bins.size(); i++) {
+            this->counts[i] = ws.histogram[this->bins[i]];
+        }
+        Histogram::clear(ws);
+    }
+
+    int ColourHistogram::getWordWidth() const {
+        return this->wordWidth;
+    }
+
+    size_t ColourHistogram::size() const {
+        return this->bins.size();
+    }
+
+    bool ColourHistogram::empty() const {
+        return this->bins.empty();
+    }
+
+    int64_t ColourHistogram::getPopulation() const {
+        int64_t population = 0;
+        for (size_t i = 0; i < this->counts.size(); i++) {
+            population += this->counts[i];
+        }
+        return population;
+    }
+
+    int64_t ColourHistogram::getCount(const Colour & c) const {
+        uint32_t bin = Histogram::quantize(c, this->wordWidth);
+        std::vector<uint32_t>::const_iterator it = std::lower_bound(this->bins.begin(), this->bins.end(), bin);
+        return (it != this->bins.end() && *it == bin ? this->counts[it - this->bins.begin()] : 0);
+    }
+
+    bool ColourHistogram::merge(const ColourHistogram & other) {
+        if (other.wordWidth != this->wordWidth) {
+            return false;
+        }
+
+        // Both lists are sorted, so they're merged in a single pass
+        std::vector<uint32_t> bins;
+        std::vector<int64_t> counts;
+        bins.reserve(this->bins.size() + other.bins.size());
+        counts.reserve(this->bins.size() + other.bins.size());
+        size_t i = 0;
+        size_t j = 0;
+        while (i < this->bins.size() || j < other.bins.size()) {
+            if (j == other.bins.size() || (i < this->bins.size() && this->bins[i] < other.bins[j])) {
+                bins.push_back(this->bins[i]);
+                counts.push_back(this->counts[i++]);
+            } else if (i == this->bins.size() || other.bins[j] < this->bins[i]) {
+                bins.push_back(other.bins[j]);
+                counts.push_back(other.counts[j++]);
+            } else {
+                bins.push_back(this->bins[i]);
+                counts.push_back(this->counts[i++] + other.counts[j++]);
+            }
+        }
+
+        this->bins.swap(bins);
+        this->counts.swap(counts);
+        return true;
+    }
+
+    bool ColourHistogram::subtract(const ColourHistogram & other) {
+        if (other.wordWidth != this->wordWidth) {
+            return false;
+        }
+
+        // Bins are compacted in place, dropping any which become empty
+        size_t j = 0;
+        size_t next = 0;
+        for (size_t i = 0; i < this->bins.size(); i++) {
+            while (j < other.bins.size() && other.bins[j] < this->bins[i]) {
+                j++;
+            }
+            int64_t count = this->counts[i];
+            if (j < other.bins.size() && other.bins[j] == this->bins[i]) {
+                count = std::max(count - other.counts[j], static_cast<int64_t>(0));
+            }
+            if (count > 0) {
+                this->bins[next] = this->bins[i];
+                this->counts[next] = count;
+                next++;
+            }
+        }
+
+        this->bins.resize(next);
+        this->counts.resize(next);
+        return true;
+    }
+
+    std::vector<uint8_t> ColourHistogram::serialize() const {
+        // Header: magic, version, word width and number of bins
+        std::vector<uint8_t> blob(BLOB_MAGIC, BLOB_MAGIC + BLOB_MAGIC_SIZE);
+        blob.push_back(BLOB_VERSION);
+        blob.push_back(this->wordWidth);
+        writeVarint(blob, this->bins.size());
+
+        // Each bin is stored as the gap from the previous one, followed by its count
+        uint32_t previous = 0;
+        for (size_t i = 0; i < this->bins.size(); i++) {
+            writeVarint(blob, this->bins[i] - previous);
+            writeVarint(blob, this->counts[i]);
+            previous = this->bins[i];
+        }
+        return blob;
+    }
+
+    bool ColourHistogram::deserialize(const std::vector<uint8_t> & blob) {
+        this->bins.clear();
+        this->counts.clear();
+
+        // Check the header
+        if (blob.size() < BLOB_MAGIC_SIZE + 2 || !std::equal(blob.begin(), blob.begin() + BLOB_MAGIC_SIZE, BLOB_MAGIC) || blob[BLOB_MAGIC_SIZE] != BLOB_VERSION) {
+            return false;
+        }
+        int width = blob[BLOB_MAGIC_SIZE + 1];
+        if (width < Histogram::MIN_WORD_WIDTH || width > Histogram::MAX_WORD_WIDTH) {
+            return false;
+        }
+
+        // Bins must be in ascending order, within the histogram and non-empty
+        size_t pos = BLOB_MAGIC_SIZE + 2;
+        uint64_t size;
+        if (!readVarint(blob, pos, size) || size > Histogram::size(width)) {
+            return false;
+        }
+        std::vector<uint32_t> bins(size);
+        std::vector<int64_t> counts(size);
+        uint64_t bin = 0;
+        for (size_t i = 0; i < size; i++) {
+            uint64_t gap;
+            uint64_t count;
+            if (!readVarint(blob, pos, gap) || !readVarint(blob, pos, count) || (i > 0 && gap == 0) || gap >= Histogram::size(width)) {
+                return false;
+            }
+            bin += gap;
+            if (bin >= Histogram::size(width) || count == 0 || count > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                return false;
+            }
+            bins[i] = bin;
+            counts[i] = count;
+        }
+        if (pos != blob.size()) {
+            return false;
+        }
+
+        this->wordWidth = width;
+        this->bins.swap(bins);
+        this->counts.swap(counts);
+        return true;
+    }
+
+    void ColourHistogram::addTo(QuantizerWorkspace & ws) const {
+        ws.setWordWidth(this->wordWidth);
+        for (size_t i = 0; i < this->bins.size(); i++) {
+            uint32_t bin = this->bins[i];
+            ws.histogram[bin] += this->counts[i];
+            ws.occupancy[bin/64] |= (static_cast<uint64_t>(1) << (bin % 64));
+        }
+    }
+
+    bool ColourHistogram::operator==(const ColourHistogram & other) const {
+        return (this->wordWidth == other.wordWidth && this->bins == other.bins && this->counts == other.counts);
+    }
+};
\ No newline at end of file
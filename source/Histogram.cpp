@@ -0,0 +1,300 @@
+#include "splash/AreaScaler.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/Simd.hpp"
+#include <algorithm>
+
+// Constants
+#define MIN_PIXELS_PER_THREAD (1 << 16)
+#define QUANTIZE_BLOCK_SIZE 256
+
+namespace Splash::Histogram {
+    // Returns whether rows in the given format can be read as 0xAARRGGBB words
+    static constexpr bool isPacked(PixelFormat f) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // B, G, R, A bytes read as a little-endian word are already 0xAARRGGBB
+        return (f == PixelFormat::ARGB8888 || f == PixelFormat::BGRA8888);
+#else
+        return (f == PixelFormat::ARGB8888);
+#endif
+    }
+
+    // Count the occurrences of each quantized colour within a row of 0xAARRGGBB words. Blocks
+    // of pixels are converted to histogram indices by the vectorized kernel before counting.
+    template <typename T>
+    static void countPackedColours(const unsigned char * row, size_t width, T * histogram) {
+        const uint32_t * pixels = reinterpret_cast<const uint32_t *>(row);
+        uint16_t indices[QUANTIZE_BLOCK_SIZE];
+        for (size_t x = 0; x < width; x += QUANTIZE_BLOCK_SIZE) {
+            size_t count = std::min(width - x, static_cast<size_t>(QUANTIZE_BLOCK_SIZE));
+            Simd::quantizeRow(pixels + x, count, indices);
+            for (size_t i = 0; i < count; i++) {
+                histogram[indices[i]]++;
+            }
+        }
+    }
+
+    // Count the occurrences of each quantized colour within a row. Pixels are read as stored
+    // without being converted to Colours first, in blocks for packed formats (the vectorized
+    // kernel only produces indices for the default word width).
+    // W is the word width and T is the type of each bin (uint16_t when the pixel count allows, otherwise int64_t).
+    template <int W, PixelFormat F, typename T>
+    static void countQuantizedColours(const unsigned char * row, size_t width, T * histogram) {
+        if (W == WORD_WIDTH && isPacked(F)) {
+            countPackedColours(row, width, histogram);
+            return;
+        }
+
+        int a, r, g, b;
+        for (size_t x = 0; x < width; x++) {
+            PixelReader<F>::read(row + (x * PixelReader<F>::size), a, r, g, b);
+            histogram[Precision<W>::quantize(r, g, b)]++;
+        }
+    }
+
+    // Count the occurrences of each quantized colour within every row of the view
+    template <int W, PixelFormat F, typename T>
+    static void countQuantizedColours(const BitmapView & view, T * histogram) {
+        for (size_t y = 0; y < view.getHeight(); y++) {
+            countQuantizedColours<W, F>(static_cast<const unsigned char *>(view.getRow(y)), view.getWidth(), histogram);
+        }
+    }
+
+    // Count the occurrences of each quantized colour within the view using the loop for its format
+    template <int W, typename T>
+    static void countQuantizedColours(const BitmapView & view, T * histogram) {
+        switch (view.getFormat()) {
+            case PixelFormat::ARGB8888:
+                countQuantizedColours<W, PixelFormat::ARGB8888>(view, histogram);
+                break;
+
+            case PixelFormat::RGBA8888:
+                countQuantizedColours<W, PixelFormat::RGBA8888>(view, histogram);
+                break;
+
+            case PixelFormat::BGRA8888:
+                countQuantizedColours<W, PixelFormat::BGRA8888>(view, histogram);
+                break;
+
+            case PixelFormat::RGB888:
+                countQuantizedColours<W, PixelFormat::RGB888>(view, histogram);
+                break;
+
+            case PixelFormat::RGB565:
+                countQuantizedColours<W, PixelFormat::RGB565>(view, histogram);
+                break;
+        }
+    }
+
+    // Returns a word with bit i set if bin i of the 64 given bins is non-zero
+    template <typename T>
+    static inline uint64_t occupiedBits(const T * bins) {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 64; i++) {
+            bits |= static_cast<uint64_t>(bins[i] != 0) << i;
+        }
+        return bits;
+    }
+
+    // Sets the occupancy bitset from the (64-bit) histogram
+    static void markOccupied(QuantizerWorkspace & ws) {
+        for (size_t w = 0; w < ws.occupancy.size(); w++) {
+            ws.occupancy[w] = occupiedBits(ws.histogram.data() + (w * 64));
+        }
+    }
+
+    // Moves the counts in the 16-bit histogram into the histogram, marking each occupied bin
+    // Only the occupied bins of the histogram are written to, and the 16-bit histogram is left zeroed
+    static void moveCompact(QuantizerWorkspace & ws) {
+        for (size_t w = 0; w < ws.occupancy.size(); w++) {
+            uint16_t * bins = ws.compact.data() + (w * 64);
+            uint64_t bits = occupiedBits(bins);
+            ws.occupancy[w] |= bits;
+            while (bits != 0) {
+                size_t i = __builtin_ctzll(bits);
+                ws.histogram[(w * 64) + i] += bins[i];
+                bins[i] = 0;
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    // Splits rows [0, rows) into contiguous shards which are counted in parallel by the given
+    // function on the workspace's threads, each into a private histogram. The private histograms
+    // are then summed into the workspace's histogram, which gives exactly the same counts as
+    // counting on a single thread. The function is passed the rows to count, the histogram to
+    // count into and whether it's being called on the calling thread (in which case it may use
+    // the workspace's buffers).
+    template <typename F>
+    static void countSharded(size_t rows, size_t width, size_t threads, QuantizerWorkspace & ws, const F & count) {
+        // Don't bother splitting if there isn't much work to go around
+        size_t shards = std::min(threads, (rows * width)/MIN_PIXELS_PER_THREAD);
+        shards = std::min(shards, rows);
+        if (shards <= 1) {
+            count(0, rows, ws.histogram, true);
+            return;
+        }
+
+        // The calling thread counts the first shard straight into the final histogram
+        if (ws.partials.size() < shards - 1) {
+            ws.partials.resize(shards - 1);
+        }
+        for (size_t i = 1; i < shards; i++) {
+            ws.partials[i - 1].assign(ws.histogram.size(), 0);
+        }
+        ws.workers.run(shards, [rows, shards, &ws, &count](size_t i) {
+            if (i == 0) {
+                count(0, rows/shards, ws.histogram, true);
+            } else {
+                count((rows * i)/shards, (rows * (i + 1))/shards, ws.partials[i - 1], false);
+            }
+        });
+
+        // Merge once every shard is done
+        for (size_t i = 0; i < shards - 1; i++) {
+            Simd::addCounts(reinterpret_cast<const uint64_t *>(ws.partials[i].data()), ws.histogram.size(), reinterpret_cast<uint64_t *>(ws.histogram.data()));
+        }
+    }
+
+    // Scales and counts the given rows using the given scaler and row buffer
+    template <int W, typename T>
+    static void countScaledRows(AreaScaler & scaler, std::vector<Colour> & row, size_t y1, size_t y2, T * histogram) {
+        for (size_t y = y1; y < y2; y++) {
+            scaler.scaleRow(y, 0, row.size(), row.data());
+            countQuantizedColours<W, PixelFormat::ARGB8888>(reinterpret_cast<const unsigned char *>(row.data()), row.size(), histogram);
+        }
+    }
+
+    // Counts the view into the workspace using W bits of each component
+    template <int W>
+    static void countView(const BitmapView & pixels, size_t threads, QuantizerWorkspace & ws) {
+        // Small views are counted on this thread using 16-bit bins, which take half the cache
+        if (pixels.getWidth() * pixels.getHeight() <= MAX_COMPACT_PIXELS) {
+            countQuantizedColours<W>(pixels, ws.compact.data());
+            moveCompact(ws);
+            return;
+        }
+
+        countSharded(pixels.getHeight(), pixels.getWidth(), threads, ws, [&pixels](size_t y1, size_t y2, std::vector<int64_t> & hist, bool) {
+            countQuantizedColours<W>(pixels.crop(0, y1, pixels.getWidth(), y2 - y1), hist.data());
+        });
+        markOccupied(ws);
+    }
+
+    // Scales and counts the view into the workspace using W bits of each component
+    template <int W>
+    static void countScaledView(const BitmapView & pixels, size_t width, size_t height, size_t threads, QuantizerWorkspace & ws) {
+        // Each scaled row is averaged into a buffer and counted straight away
+        if (width * height <= MAX_COMPACT_PIXELS) {
+            ws.scaler.reset(pixels, width, height, false);
+            ws.row.resize(width);
+            countScaledRows<W>(ws.scaler, ws.row, 0, height, ws.compact.data());
+            moveCompact(ws);
+            return;
+        }
+
+        countSharded(height, width, threads, ws, [&pixels, width, height, &ws](size_t y1, size_t y2, std::vector<int64_t> & hist, bool caller) {
+            if (caller) {
+                ws.scaler.reset(pixels, width, height, false);
+                ws.row.resize(width);
+                countScaledRows<W>(ws.scaler, ws.row, y1, y2, hist.data());
+
+            } else {
+                AreaScaler scaler = AreaScaler(pixels, width, height, false);
+                std::vector<Colour> row(width);
+                countScaledRows<W>(scaler, row, y1, y2, hist.data());
+            }
+        });
+        markOccupied(ws);
+    }
+
+    size_t size(int width) {
+        return static_cast<size_t>(1) << (width * 3);
+    }
+
+    int quantize(const Colour & c, int width) {
+        const int shift = 8 - width;
+        return ((c.r() >> shift) << (width + width)) | ((c.g() >> shift) << width) | (c.b() >> shift);
+    }
+
+    Colour colour(int c, int width) {
+        const int mask = (1 << width) - 1;
+        const int shift = 8 - width;
+        return Colour(255, ((c >> (width * 2)) & mask) << shift, ((c >> width) & mask) << shift, (c & mask) << shift);
+    }
+
+    void count(const BitmapView & pixels, size_t threads, QuantizerWorkspace & ws) {
+        switch (ws.getWordWidth()) {
+            case 4:
+                countView<4>(pixels, threads, ws);
+                break;
+
+            case 5:
+                countView<5>(pixels, threads, ws);
+                break;
+
+            case 6:
+                countView<6>(pixels, threads, ws);
+                break;
+        }
+    }
+
+    void countScaled(const BitmapView & pixels, size_t width, size_t height, size_t threads, QuantizerWorkspace & ws) {
+        switch (ws.getWordWidth()) {
+            case 4:
+                countScaledView<4>(pixels, width, height, threads, ws);
+                break;
+
+            case 5:
+                countScaledView<5>(pixels, width, height, threads, ws);
+                break;
+
+            case 6:
+                countScaledView<6>(pixels, width, height, threads, ws);
+                break;
+        }
+    }
+
+    std::vector<int64_t> count(const BitmapView & pixels, size_t threads) {
+        QuantizerWorkspace ws;
+        count(pixels, threads, ws);
+        return ws.histogram;
+    }
+
+    std::vector<int64_t> countScaled(const BitmapView & pixels, size_t width, size_t height, size_t threads) {
+        QuantizerWorkspace ws;
+        countScaled(pixels, width, height, threads, ws);
+        return ws.histogram;
+    }
+
+    void filter(QuantizerWorkspace & ws, const Filter::FilterMask & mask) {
+        const uint64_t * allowed = mask.data();
+        ws.colours.clear();
+        for (size_t w = 0; w < ws.occupancy.size(); w++) {
+            // Set population to zero if it should be ignored
+            uint64_t ignored = ws.occupancy[w] & ~allowed[w];
+            while (ignored != 0) {
+                ws.histogram[(w * 64) + __builtin_ctzll(ignored)] = 0;
+                ignored &= ignored - 1;
+            }
+
+            // List those which remain
+            uint64_t bits = ws.occupancy[w] & allowed[w];
+            ws.occupancy[w] = bits;
+            while (bits != 0) {
+                ws.colours.push_back((w * 64) + __builtin_ctzll(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    void clear(QuantizerWorkspace & ws) {
+        // Every other bin was either empty or has been zeroed by filter()
+        for (size_t i = 0; i < ws.colours.size(); i++) {
+            ws.histogram[ws.colours[i]] = 0;
+            ws.occupancy[ws.colours[i] / 64] = 0;
+        }
+        ws.colours.clear();
+    }
+};
\ No newline at end of file
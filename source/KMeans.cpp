@@ -0,0 +1,137 @@
+#include "splash/ColourUtils.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/KMeans.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/Simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+// Centroids are padded to a multiple of this (required by Simd::nearestCentroids())
+#define CENTROID_ALIGN 8
+
+// Position used for padding centroids, so they're never the nearest
+#define FAR_AWAY 1.0e6f
+
+namespace Splash::KMeans {
+    // Tables for each word width, built on first use
+    static std::vector<float> tables[Histogram::MAX_WORD_WIDTH - Histogram::MIN_WORD_WIDTH + 1];
+    static std::mutex tablesMutex;
+
+    const std::vector<float> & labTable(int width) {
+        std::lock_guard<std::mutex> lock(tablesMutex);
+        std::vector<float> & table = tables[width - Histogram::MIN_WORD_WIDTH];
+        if (table.empty()) {
+            table.resize(Histogram::size(width) * 4);
+            for (size_t i = 0; i < Histogram::size(width); i++) {
+                Colour c = Histogram::colour(i, width);
+                ColourUtils::LAB lab = ColourUtils::colourToLAB(c);
+                table[i * 4] = lab.l;
+                table[i * 4 + 1] = lab.a;
+                table[i * 4 + 2] = lab.b;
+                table[i * 4 + 3] = 0;
+            }
+        }
+
+        // The table is never changed once built, so it can be read without the lock
+        return table;
+    }
+
+    std::vector<Swatch> refine(QuantizerWorkspace & ws, const std::vector<Swatch> & swatches, const Filter::FilterMask & mask, int iterations, double budget) {
+        const size_t n = ws.colours.size();
+        const size_t k = swatches.size();
+        if (n == 0 || k == 0 || iterations <= 0) {
+            return swatches;
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const int width = ws.getWordWidth();
+
+        // Gather the LAB value of each occupied bin so the iterations read them contiguously
+        const std::vector<float> & table = labTable(width);
+        ws.points.resize(n * 4);
+        for (size_t i = 0; i < n; i++) {
+            const float * lab = table.data() + (ws.colours[i] * 4);
+            std::copy(lab, lab + 4, ws.points.data() + (i * 4));
+        }
+
+        // Start from the given swatches, with the padding placed far away from every colour
+        const size_t padded = ((k + CENTROID_ALIGN - 1)/CENTROID_ALIGN) * CENTROID_ALIGN;
+        ws.centroids.assign(padded * 3, FAR_AWAY);
+        for (size_t j = 0; j < k; j++) {
+            Colour c = swatches[j].getColour();
+            ColourUtils::LAB lab = ColourUtils::colourToLAB(c);
+            ws.centroids[j] = lab.l;
+            ws.centroids[padded + j] = lab.a;
+            ws.centroids[(padded * 2) + j] = lab.b;
+        }
+
+        ws.nearest.resize(n);
+        ws.previous.assign(n, k);
+        for (int it = 0; it < iterations; it++) {
+            Simd::nearestCentroids(ws.points.data(), n, ws.centroids.data(), padded, ws.nearest.data());
+            if (ws.nearest == ws.previous) {
+                break;
+            }
+            ws.nearest.swap(ws.previous);
+
+            // Move each centroid to the weighted mean of its colours (empty ones stay put)
+            ws.sums.assign(k * 4, 0);
+            for (size_t i = 0; i < n; i++) {
+                double weight = ws.histogram[ws.colours[i]];
+                double * sum = ws.sums.data() + (ws.previous[i] * 4);
+                sum[0] += weight;
+                sum[1] += weight * ws.points[i * 4];
+                sum[2] += weight * ws.points[i * 4 + 1];
+                sum[3] += weight * ws.points[i * 4 + 2];
+            }
+            for (size_t j = 0; j < k; j++) {
+                const double * sum = ws.sums.data() + (j * 4);
+                if (sum[0] > 0) {
+                    ws.centroids[j] = sum[1]/sum[0];
+                    ws.centroids[padded + j] = sum[2]/sum[0];
+                    ws.centroids[(padded * 2) + j] = sum[3]/sum[0];
+                }
+            }
+
+            // Checked after each iteration so at least one always runs
+            std::chrono::duration<double, std::milli> taken = std::chrono::steady_clock::now() - start;
+            if (budget > 0 && taken.count() >= budget) {
+                break;
+            }
+        }
+
+        // Form the swatches from the final assignment, averaging their colours in RGB so that
+        // the result is always a valid colour. Each bin's components are shifted up to 8 bits
+        // (as Histogram::colour() does) before averaging, whereas the median cut quantizer
+        // rounds its means at the word width, so a refined swatch can differ slightly from an
+        // unrefined one covering the same colours
+        const int componentMask = (1 << width) - 1;
+        const int shift = 8 - width;
+        std::vector<int64_t> totals(k * 4, 0);
+        for (size_t i = 0; i < n; i++) {
+            uint32_t bin = ws.colours[i];
+            int64_t weight = ws.histogram[bin];
+            int64_t * total = totals.data() + (ws.previous[i] * 4);
+            total[0] += weight;
+            total[1] += weight * (((bin >> (width * 2)) & componentMask) << shift);
+            total[2] += weight * (((bin >> width) & componentMask) << shift);
+            total[3] += weight * ((bin & componentMask) << shift);
+        }
+
+        std::vector<Swatch> refined;
+        for (size_t j = 0; j < k; j++) {
+            const int64_t * total = totals.data() + (j * 4);
+            if (total[0] == 0) {
+                continue;
+            }
+
+            Colour c = Colour(255, std::round(static_cast<double>(total[1])/total[0]), std::round(static_cast<double>(total[2])/total[0]), std::round(static_cast<double>(total[3])/total[0]));
+            if (mask.isAllowed(Histogram::quantize(c, width))) {
+                refined.push_back(Swatch(c, total[0]));
+            }
+        }
+        return refined;
+    }
+};
\ No newline at end of file
@@ -20,6 +20,7 @@ namespace Splash {
     // Static colours
     static Colour COLOUR_BLACK = Colour(255, 0, 0, 0);
     static Colour COLOUR_WHITE = Colour(255, 255, 255, 255);
+    static const Swatch NO_SWATCH = Swatch();
 
     // Helper function to check if colour is black or white
     bool isWhiteOrBlack(Colour & col) {
@@ -27,10 +28,9 @@ namespace Splash {
         return (hsl.l <= BLACK_MAX_LIGHTNESS || hsl.l >= WHITE_MIN_LIGHTNESS);
     }
 
-    MediaStyle::MediaStyle(Bitmap & bmap) {
+    MediaStyle::MediaStyle(const BitmapView & bmap) {
         this->emptyHSL = true;
-        this->image = bmap;
-        this->generatePalette();
+        this->generatePalette(bmap);
     }
 
     void MediaStyle::ensureColours(Colour & bg, Colour & fg) {
@@ -63,50 +63,53 @@ namespace Splash {
         }
     }
 
-    void MediaStyle::generatePalette() {
+    void MediaStyle::generatePalette(const BitmapView & bmap) {
         // Only do something if the bitmap is valid
-        if (!this->image.isValid()) {
+        if (!bmap.isValid()) {
             return;
         }
 
         // Define some useful variables
         Colour fgColour;
-        size_t height = this->image.getHeight();
-        size_t width = this->image.getWidth();
+        size_t height = bmap.getHeight();
+        size_t width = bmap.getWidth();
         size_t area = width * height;
 
-        // Resize the image if it is too large
+        // Resize the image if it is too large, otherwise use the pixels in place
+        Bitmap scaled;
+        BitmapView image = bmap;
         if (area > RESIZE_BITMAP_AREA) {
             double factor = std::sqrt(RESIZE_BITMAP_AREA/(float)area);
             width *= factor;
             height *= factor;
-            this->image = this->image.createScaledBitmap(width, height);
+            scaled = bmap.createScaledBitmap(width, height);
+            image = scaled;
         }
 
         // Generate palette from image
-        Palette::Builder builder = Palette::from(this->image);
+        Palette::Builder builder = Palette::from(image);
         builder.clearFilters();
         builder.resizeBitmapArea(RESIZE_BITMAP_AREA);
-        std::shared_ptr<Palette> palette = builder.generate();
+        Palette palette = builder.generate();
 
-        // Get colours
-        this->backgroundColour = this->findBackgroundColour();
+        // Get colours (the foreground is picked from a palette without the background's hue)
+        this->backgroundColour = this->findBackgroundColour(palette);
         if (!this->emptyHSL) {
             Filter::Hue * f = new Filter::Hue(this->filteredBackgroundHSL.h);
             builder.addFilter(f);
         }
         Filter::BlackWhite * ff = new Filter::BlackWhite();
         builder.addFilter(ff);
-        palette = builder.generate();
+        builder.generate(palette);
         fgColour = this->selectForegroundColour(this->backgroundColour, palette);
         this->ensureColours(this->backgroundColour, fgColour);
     }
 
-    Colour MediaStyle::selectForegroundColour(Colour & bgColour, std::shared_ptr<Palette> p) {
+    Colour MediaStyle::selectForegroundColour(Colour & bgColour, const Palette & p) {
         if (this->isColourLight(bgColour)) {
-            return selectForegroundColourForSwatches(p->getDarkVibrantSwatch(), p->getVibrantSwatch(), p->getDarkMutedSwatch(), p->getMutedSwatch(), p->getDominantSwatch(), COLOUR_BLACK);
+            return selectForegroundColourForSwatches(p.getDarkVibrantSwatch(), p.getVibrantSwatch(), p.getDarkMutedSwatch(), p.getMutedSwatch(), p.getDominantSwatch(), COLOUR_BLACK);
         } else {
-            return selectForegroundColourForSwatches(p->getLightVibrantSwatch(), p->getVibrantSwatch(), p->getLightMutedSwatch(), p->getMutedSwatch(), p->getDominantSwatch(), COLOUR_WHITE);
+            return selectForegroundColourForSwatches(p.getLightVibrantSwatch(), p.getVibrantSwatch(), p.getLightMutedSwatch(), p.getMutedSwatch(), p.getDominantSwatch(), COLOUR_WHITE);
         }
     }
 
@@ -118,23 +121,23 @@ namespace Splash {
         return this->isColourLight(this->backgroundColour);
     }
 
-    Colour MediaStyle::selectForegroundColourForSwatches(Swatch mVibrant, Swatch vibrant, Swatch mMuted, Swatch muted, Swatch dominant, Colour & fallback) {
+    Colour MediaStyle::selectForegroundColourForSwatches(const Swatch & mVibrant, const Swatch & vibrant, const Swatch & mMuted, const Swatch & muted, const Swatch & dominant, Colour & fallback) {
         // Try to find a fitting vibrant or muted swatch
-        Swatch colouredCandidate = this->selectVibrantCandidate(mVibrant, vibrant);
-        if (!colouredCandidate.isValid()) {
-            colouredCandidate = this->selectMutedCandidate(muted, mMuted);
+        const Swatch * colouredCandidate = &this->selectVibrantCandidate(mVibrant, vibrant);
+        if (!colouredCandidate->isValid()) {
+            colouredCandidate = &this->selectMutedCandidate(muted, mMuted);
         }
 
         // If a swatch if found determine which one to return
-        if (colouredCandidate.isValid()) {
-            if (dominant == colouredCandidate) {
-                return colouredCandidate.getColour();
+        if (colouredCandidate->isValid()) {
+            if (dominant == *colouredCandidate) {
+                return colouredCandidate->getColour();
 
-            } else if ((float) colouredCandidate.getPopulation()/dominant.getPopulation() < POPULATION_FRACTION_FOR_DOMINANT && dominant.getColour().hsl().s > MIN_SATURATION_WHEN_DECIDING) {
+            } else if ((float) colouredCandidate->getPopulation()/dominant.getPopulation() < POPULATION_FRACTION_FOR_DOMINANT && dominant.getColour().hsl().s > MIN_SATURATION_WHEN_DECIDING) {
                 return dominant.getColour();
 
             } else {
-                return colouredCandidate.getColour();
+                return colouredCandidate->getColour();
             }
 
         // If no suitable swatch try dominant colour
@@ -146,7 +149,7 @@ namespace Splash {
         return fallback;
     }
 
-    Swatch MediaStyle::selectMutedCandidate(Swatch & first, Swatch & second) {
+    const Swatch & MediaStyle::selectMutedCandidate(const Swatch & first, const Swatch & second) {
         bool firstValid = this->hasEnoughPopulation(first);
         bool secondValid = this->hasEnoughPopulation(second);
 
@@ -170,10 +173,10 @@ namespace Splash {
         }
 
         // If neither are valid return an invalid swatch
-        return Swatch();
+        return NO_SWATCH;
     }
 
-    Swatch MediaStyle::selectVibrantCandidate(Swatch & first, Swatch & second) {
+    const Swatch & MediaStyle::selectVibrantCandidate(const Swatch & first, const Swatch & second) {
         bool firstValid = this->hasEnoughPopulation(first);
         bool secondValid = this->hasEnoughPopulation(second);
 
@@ -196,22 +199,16 @@ namespace Splash {
         }
 
         // If neither are valid return an invalid swatch
-        return Swatch();
+        return NO_SWATCH;
     }
 
-    bool MediaStyle::hasEnoughPopulation(Swatch & swatch) {
+    bool MediaStyle::hasEnoughPopulation(const Swatch & swatch) {
         return (swatch.isValid() && (swatch.getPopulation()/(float)RESIZE_BITMAP_AREA) > MINIMUM_IMAGE_FRACTION);
     }
 
-    Colour MediaStyle::findBackgroundColour() {
-        // Generate the palette
-        Palette::Builder builder = Palette::from(this->image);
-        builder.clearFilters();
-        builder.resizeBitmapArea(RESIZE_BITMAP_AREA);
-        std::shared_ptr<Palette> palette = builder.generate();
-
+    Colour MediaStyle::findBackgroundColour(const Palette & palette) {
         // Check if we can use the dominant swatch
-        Swatch dominant = palette->getDominantSwatch();
+        const Swatch & dominant = palette.getDominantSwatch();
         if (!dominant.isValid()) {
             this->emptyHSL = true;
             return COLOUR_WHITE;
@@ -226,7 +223,7 @@ namespace Splash {
         }
 
         // If not then it's black or white so check the second colour
-        std::vector<Swatch> swatches = palette->getSwatches();
+        const std::vector<Swatch> & swatches = palette.getSwatches();
         float highestNonWhitePop = -1;
         Swatch second = Swatch();
         for (size_t i = 0; i < swatches.size(); i++) {
@@ -0,0 +1,254 @@
+#include "splash/Histogram.hpp"
+#include "splash/OctreeQuantizer.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Number of levels below the root (one per bit of each component)
+#define MAX_LEVEL 8
+
+// Smallest pool allowed, so that merging always frees enough nodes for a new colour
+#define MIN_NODES 64
+
+// Value of lastColour when no colour has been cached (colours only use the low 24 bits)
+#define NO_COLOUR 0xFFFFFFFF
+
+namespace Splash {
+    const uint32_t OctreeQuantizer::NONE;
+    const size_t OctreeQuantizer::DEFAULT_MAX_NODES;
+
+    OctreeQuantizer::OctreeQuantizer(int maxColours, std::vector<Filter::Filter *> & filters, size_t maxNodes) : OctreeQuantizer(maxColours, Filter::FilterMask::get(filters), maxNodes) {
+
+    }
+
+    OctreeQuantizer::OctreeQuantizer(int maxColours, const std::shared_ptr<const Filter::FilterMask> & mask, size_t maxNodes) {
+        this->maxColours = std::max(maxColours, 1);
+        this->mask = mask;
+
+        // Link every node into the free list, then take the root
+        this->nodes.resize(std::max(maxNodes, static_cast<size_t>(MIN_NODES)));
+        for (size_t i = 0; i < this->nodes.size(); i++) {
+            this->nodes[i].next = (i + 1 < this->nodes.size() ? i + 1 : NONE);
+        }
+        this->freeNodes = 0;
+        this->used = 0;
+        this->branches.assign(MAX_LEVEL, NONE);
+        this->leafLevel = MAX_LEVEL;
+        this->leaves = 0;
+        this->allocate(0);
+
+        this->lastColour = NO_COLOUR;
+        this->lastLeaf = NONE;
+    }
+
+    uint32_t OctreeQuantizer::allocate(int level) {
+        uint32_t index = this->freeNodes;
+        Node & node = this->nodes[index];
+        this->freeNodes = node.next;
+        this->used++;
+
+        node.red = node.green = node.blue = node.count = 0;
+        std::fill(node.children, node.children + 8, NONE);
+        node.level = level;
+        node.leaf = (level >= this->leafLevel);
+        node.next = NONE;
+
+        // Branches are linked into the list for their level
+        if (node.leaf) {
+            this->leaves++;
+        } else {
+            node.next = this->branches[level];
+            this->branches[level] = index;
+        }
+        return index;
+    }
+
+    void OctreeQuantizer::reduce() {
+        // The deepest branches only have leaves as children
+        int level = MAX_LEVEL - 1;
+        while (level >= 0 && this->branches[level] == NONE) {
+            level--;
+        }
+        if (level < 0) {
+            return;
+        }
+
+        // Find the least common branch on the level (and the one before it in the list)
+        uint32_t best = NONE;
+        uint32_t bestPrev = NONE;
+        uint64_t bestCount = 0;
+        uint32_t prev = NONE;
+        for (uint32_t i = this->branches[level]; ; i = this->nodes[i].next) {
+            uint64_t count = 0;
+            for (size_t c = 0; c < 8; c++) {
+                if (this->nodes[i].children[c] != NONE) {
+                    count += this->nodes[this->nodes[i].children[c]].count;
+                }
+            }
+            if (i == this->branches[level] || count < bestCount) {
+                best = i;
+                bestPrev = prev;
+                bestCount = count;
+            }
+
+            prev = i;
+            if (this->nodes[i].next == NONE) {
+                break;
+            }
+        }
+
+        // Unlink it from the level's list
+        Node & node = this->nodes[best];
+        if (best == this->branches[level]) {
+            this->branches[level] = node.next;
+        } else {
+            this->nodes[bestPrev].next = node.next;
+        }
+
+        // Fold the children into it and return them to the pool
+        for (size_t c = 0; c < 8; c++) {
+            uint32_t index = node.children[c];
+            if (index == NONE) {
+                continue;
+            }
+
+            Node & child = this->nodes[index];
+            node.red += child.red;
+            node.green += child.green;
+            node.blue += child.blue;
+            node.count += child.count;
+            child.next = this->freeNodes;
+            this->freeNodes = index;
+            this->used--;
+            this->leaves--;
+            node.children[c] = NONE;
+        }
+        node.leaf = true;
+        node.next = NONE;
+        this->leaves++;
+
+        // New colours stop at this level from now on, so the tree can't grow back past it
+        this->leafLevel = std::min(this->leafLevel, level + 1);
+        this->lastColour = NO_COLOUR;
+    }
+
+    void OctreeQuantizer::add(uint32_t rgb, uint64_t count) {
+        if (rgb == this->lastColour) {
+            Node & leaf = this->nodes[this->lastLeaf];
+            leaf.red += ((rgb >> 16) & 0xff) * count;
+            leaf.green += ((rgb >> 8) & 0xff) * count;
+            leaf.blue += (rgb & 0xff) * count;
+            leaf.count += count;
+            return;
+        }
+
+        // Check the quantized colour is allowed
+        const int width = this->mask->getWordWidth();
+        const int shift = 8 - width;
+        size_t quantized = ((((rgb >> 16) & 0xff) >> shift) << (width * 2)) | ((((rgb >> 8) & 0xff) >> shift) << width) | ((rgb & 0xff) >> shift);
+        if (!this->mask->isAllowed(quantized)) {
+            return;
+        }
+
+        // Make sure there are enough free nodes for a whole path
+        while (this->nodes.size() - this->used < static_cast<size_t>(this->leafLevel)) {
+            this->reduce();
+        }
+
+        // Walk down to the leaf, creating any missing nodes on the way
+        uint32_t index = 0;
+        while (!this->nodes[index].leaf) {
+            int bit = 7 - this->nodes[index].level;
+            int c = (((rgb >> (16 + bit)) & 1) << 2) | (((rgb >> (8 + bit)) & 1) << 1) | ((rgb >> bit) & 1);
+            if (this->nodes[index].children[c] == NONE) {
+                uint32_t child = this->allocate(this->nodes[index].level + 1);
+                this->nodes[index].children[c] = child;
+            }
+            index = this->nodes[index].children[c];
+        }
+
+        this->lastColour = rgb;
+        this->lastLeaf = index;
+        this->add(rgb, count);
+    }
+
+    template <PixelFormat F>
+    void OctreeQuantizer::addPixels(const BitmapView & view) {
+        int a, r, g, b;
+        for (size_t y = 0; y < view.getHeight(); y++) {
+            const unsigned char * row = static_cast<const unsigned char *>(view.getRow(y));
+            for (size_t x = 0; x < view.getWidth(); x++) {
+                PixelReader<F>::read(row + (x * PixelReader<F>::size), a, r, g, b);
+                this->add((r << 16) | (g << 8) | b, 1);
+            }
+        }
+    }
+
+    void OctreeQuantizer::add(const BitmapView & view) {
+        switch (view.getFormat()) {
+            case PixelFormat::ARGB8888:
+                this->addPixels<PixelFormat::ARGB8888>(view);
+                break;
+
+            case PixelFormat::RGBA8888:
+                this->addPixels<PixelFormat::RGBA8888>(view);
+                break;
+
+            case PixelFormat::BGRA8888:
+                this->addPixels<PixelFormat::BGRA8888>(view);
+                break;
+
+            case PixelFormat::RGB888:
+                this->addPixels<PixelFormat::RGB888>(view);
+                break;
+
+            case PixelFormat::RGB565:
+                this->addPixels<PixelFormat::RGB565>(view);
+                break;
+        }
+    }
+
+    void OctreeQuantizer::add(const Colour & colour, int64_t count) {
+        if (count > 0) {
+            this->add(colour.raw() & 0xFFFFFF, count);
+        }
+    }
+
+    size_t OctreeQuantizer::getNodeCount() const {
+        return this->used;
+    }
+
+    std::vector<Swatch> OctreeQuantizer::getQuantizedColours() {
+        while (this->leaves > static_cast<size_t>(this->maxColours) && !this->nodes[0].leaf) {
+            this->reduce();
+        }
+
+        // Visit the leaves depth first, so they're returned in order of colour
+        std::vector<Swatch> swatches;
+        uint32_t stack[MAX_LEVEL * 8 + 1];
+        size_t size = 0;
+        stack[size++] = 0;
+        while (size > 0) {
+            const Node & node = this->nodes[stack[--size]];
+            if (!node.leaf) {
+                for (int c = 7; c >= 0; c--) {
+                    if (node.children[c] != NONE) {
+                        stack[size++] = node.children[c];
+                    }
+                }
+                continue;
+            }
+
+            if (node.count == 0) {
+                continue;
+            }
+            double count = node.count;
+            Colour colour = Colour(255, std::round(node.red/count), std::round(node.green/count), std::round(node.blue/count));
+
+            // As the colour is averaged it may not be a colour we want
+            if (this->mask->isAllowed(Histogram::quantize(colour, this->mask->getWordWidth()))) {
+                swatches.push_back(Swatch(colour, node.count));
+            }
+        }
+        return swatches;
+    }
+};
\ No newline at end of file
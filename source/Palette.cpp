@@ -1,49 +1,27 @@
-#include "splash/ColourCutQuantizer.hpp"
 #include "splash/filter/Default.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/KMeans.hpp"
 #include "splash/Palette.hpp"
-#include "splash/target/DarkMuted.hpp"
-#include "splash/target/DarkVibrant.hpp"
-#include "splash/target/Muted.hpp"
-#include "splash/target/LightMuted.hpp"
-#include "splash/target/LightVibrant.hpp"
-#include "splash/target/Vibrant.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/Simd.hpp"
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <thread>
 
 // Constants
 #define DEFAULT_RESIZE_BITMAP_AREA (112 * 112)
 #define DEFAULT_CALCULATE_NUMBER_COLORS 16
 
 namespace Splash {
-    Palette::Palette(const std::vector<Swatch> & s, const std::vector<Target::Target> & t) {
-        this->swatches = s;
-        this->targets = t;
-
-        this->selectedSwatches.clear();
-        this->usedColours.clear();
-
-        this->dominantSwatch = this->findDominantSwatch();
-    }
+    const Swatch Palette::INVALID_SWATCH = Swatch();
 
-    Palette::Palette(const Palette & p) {
-        this->swatches = p.swatches;
-        this->targets = p.targets;
-        this->selectedSwatches = p.selectedSwatches;
-        this->usedColours = p.usedColours;
-        this->dominantSwatch = p.dominantSwatch;
+    Palette::Palette() {
+        this->dominantSwatch = Swatch();
     }
 
-    Palette::Palette(const Palette * p) {
-        this->swatches = p->swatches;
-        this->targets = p->targets;
-        this->selectedSwatches = p->selectedSwatches;
-        this->usedColours = p->usedColours;
-        this->dominantSwatch = p->dominantSwatch;
-    }
-
-    Swatch Palette::findDominantSwatch() {
-        int maxPop = std::numeric_limits<int>::min();
+    Swatch Palette::findDominantSwatch() const {
+        int64_t maxPop = std::numeric_limits<int64_t>::min();
         Swatch maxSwatch = Swatch();
         for (size_t i = 0; i < this->swatches.size(); i++) {
             Swatch swatch = this->swatches[i];
@@ -55,152 +33,208 @@ namespace Splash {
         return maxSwatch;
     }
 
-    float Palette::generateScore(const Swatch & swatch, const Target::Target & target) {
-        HSL hsl = swatch.getColour().hsl();
-
-        float sScore = 0;
-        float lScore = 0;
-        float popScore = 0;
-
-        size_t maxPop = (this->dominantSwatch.isValid() ? this->dominantSwatch.getPopulation() : 1);
-
-        if (target.getSaturationWeight() > 0) {
-            sScore = target.getSaturationWeight() * (1.0f - std::abs(hsl.s - target.getTargetSaturation()));
-        }
-        if (target.getLightnessWeight() > 0) {
-            lScore = target.getLightnessWeight() * (1.0f - std::abs(hsl.l - target.getTargetLightness()));
-        }
-        if (target.getPopulationWeight() > 0) {
-            popScore = target.getPopulationWeight() * (swatch.getPopulation() / (float)maxPop);
+    void Palette::createScoringTable() {
+        size_t count = this->swatches.size();
+        this->table.resize(count * 3);
+        int64_t maxPop = (this->dominantSwatch.isValid() ? this->dominantSwatch.getPopulation() : 1);
+        for (size_t i = 0; i < count; i++) {
+            HSL hsl = this->swatches[i].getColour().hsl();
+            this->table[i] = hsl.s;
+            this->table[count + i] = hsl.l;
+            this->table[(count * 2) + i] = this->swatches[i].getPopulation() / (float)maxPop;
         }
+    }
 
-        return sScore + lScore + popScore;
+    void Palette::scoreTargets() {
+        this->createScoringTable();
+        this->scores.resize(this->targets.size() * this->swatches.size());
+        Simd::scoreTargets(this->table.data(), this->swatches.size(), this->targets.getScoringValues(), this->targets.size(), this->scores.data());
     }
 
-    Swatch Palette::generateScoredTarget(const Target::Target & target) {
-        Swatch maxScoreSwatch = this->getMaxScoredSwatchForTarget(target);
-        if (maxScoreSwatch.isValid() && target.isExclusive()) {
-            this->usedColours[maxScoreSwatch.getColour().raw()] = true;
+    void Palette::findColourIndices() {
+        // Sort the swatches by colour so that equal colours are next to each other
+        this->order.resize(this->swatches.size());
+        for (size_t i = 0; i < this->order.size(); i++) {
+            this->order[i] = i;
+        }
+        std::sort(this->order.begin(), this->order.end(), [this](uint32_t a, uint32_t b) {
+            return static_cast<uint32_t>(this->swatches[a].getColour().raw()) < static_cast<uint32_t>(this->swatches[b].getColour().raw());
+        });
+
+        this->colours.resize(this->swatches.size());
+        uint32_t index = 0;
+        for (size_t i = 0; i < this->order.size(); i++) {
+            if (i > 0 && this->swatches[this->order[i]].getColour().raw() != this->swatches[this->order[i - 1]].getColour().raw()) {
+                index++;
+            }
+            this->colours[this->order[i]] = index;
         }
-        return maxScoreSwatch;
     }
 
-    Swatch Palette::getMaxScoredSwatchForTarget(const Target::Target & target) {
-        float maxScore = 0;
-        Swatch maxScoreSwatch = Swatch();
-
+    int Palette::getMaxScoredSwatch(const float * scores) const {
+        // Ties go to the first swatch
+        float maxScore = -std::numeric_limits<float>::infinity();
+        int maxIndex = -1;
         for (size_t i = 0; i < this->swatches.size(); i++) {
-            Swatch swatch = this->swatches[i];
-            if (this->shouldBeScoredForTarget(swatch, target)) {
-                float score = generateScore(swatch, target);
-                if (!maxScoreSwatch.isValid() || score > maxScore) {
-                    maxScoreSwatch = swatch;
-                    maxScore = score;
-                }
+            uint32_t colour = this->colours[i];
+            if (scores[i] > maxScore && !(this->used[colour >> 6] & (1ull << (colour & 63)))) {
+                maxIndex = i;
+                maxScore = scores[i];
             }
         }
-
-        return maxScoreSwatch;
+        return maxIndex;
     }
 
-    bool Palette::shouldBeScoredForTarget(const Swatch & swatch, const Target::Target & target) {
-        // Check colour hasn't been used already
-        Colour col = swatch.getColour();
-        if (this->usedColours.count(col.raw()) > 0) {
-            return false;
-        }
+    void Palette::generate(std::vector<Swatch> & s, const Target::TargetSet & t) {
+        this->swatches.swap(s);
+        this->targets = t;
+        this->dominantSwatch = this->findDominantSwatch();
 
-        // Check HSL within range
-        HSL hsl = col.hsl();
-        return (hsl.s >= target.getMinimumSaturation() && hsl.s <= target.getMaximumSaturation() && hsl.l >= target.getMinimumLightness() && hsl.l <= target.getMaximumLightness());
-    }
+        // Every target is scored at once, but swatches are picked in order as exclusive
+        // targets remove their swatch's colour from the following targets
+        this->scoreTargets();
+        this->findColourIndices();
+        this->used.assign((this->swatches.size() + 63)/64, 0);
 
-    void Palette::generate() {
-        // Make sure scored targets are generated first
+        this->selectedSwatches.assign(this->targets.size(), Swatch());
         for (size_t i = 0; i < this->targets.size(); i++) {
-            Target::Target target = this->targets[i];
-            target.normalizeWeights();
-            this->selectedSwatches[target] = this->generateScoredTarget(target);
+            int index = this->getMaxScoredSwatch(this->scores.data() + i * this->swatches.size());
+            if (index < 0) {
+                continue;
+            }
+
+            this->selectedSwatches[i] = this->swatches[index];
+            if (this->targets.get(i).isExclusive()) {
+                this->used[this->colours[index] >> 6] |= (1ull << (this->colours[index] & 63));
+            }
         }
 
-        // Now clear out used colours
-        this->usedColours.clear();
+        // Emptied rather than freed, so copies of the palette don't carry them but they're
+        // reused if the palette is generated into again
+        this->table.clear();
+        this->scores.clear();
+        this->order.clear();
+        this->colours.clear();
+        this->used.clear();
     }
 
-    std::vector<Swatch> Palette::getSwatches() {
+    const std::vector<Swatch> & Palette::getSwatches() const {
         return this->swatches;
     }
 
-    std::vector<Target::Target> Palette::getTargets() {
-        return this->targets;
+    const std::vector<Target::Target> & Palette::getTargets() const {
+        return this->targets.getTargets();
     }
 
-    Swatch Palette::getVibrantSwatch() {
-        return this->getSwatchForTarget(Target::VIBRANT);
+    const Swatch & Palette::getVibrantSwatch() const {
+        return this->getSwatchForTarget(this->targets.getDefaultHandle(Target::Default::Vibrant));
     }
 
-    Swatch Palette::getLightVibrantSwatch() {
-        return this->getSwatchForTarget(Target::LIGHT_VIBRANT);
+    const Swatch & Palette::getLightVibrantSwatch() const {
+        return this->getSwatchForTarget(this->targets.getDefaultHandle(Target::Default::LightVibrant));
     }
 
-    Swatch Palette::getDarkVibrantSwatch() {
-        return this->getSwatchForTarget(Target::DARK_VIBRANT);
+    const Swatch & Palette::getDarkVibrantSwatch() const {
+        return this->getSwatchForTarget(this->targets.getDefaultHandle(Target::Default::DarkVibrant));
     }
 
-    Swatch Palette::getMutedSwatch() {
-        return this->getSwatchForTarget(Target::MUTED);
+    const Swatch & Palette::getMutedSwatch() const {
+        return this->getSwatchForTarget(this->targets.getDefaultHandle(Target::Default::Muted));
     }
 
-    Swatch Palette::getLightMutedSwatch() {
-        return this->getSwatchForTarget(Target::LIGHT_MUTED);
+    const Swatch & Palette::getLightMutedSwatch() const {
+        return this->getSwatchForTarget(this->targets.getDefaultHandle(Target::Default::LightMuted));
     }
 
-    Swatch Palette::getDarkMutedSwatch() {
-        return this->getSwatchForTarget(Target::DARK_MUTED);
+    const Swatch & Palette::getDarkMutedSwatch() const {
+        return this->getSwatchForTarget(this->targets.getDefaultHandle(Target::Default::DarkMuted));
     }
 
-    Swatch Palette::getSwatchForTarget(const Target::Target & t) {
-        return this->selectedSwatches[t];
+    const Swatch & Palette::getSwatchForTarget(const Target::Target & t) const {
+        return this->getSwatchForTarget(this->targets.find(t));
     }
 
-    Swatch Palette::getDominantSwatch() {
+    const Swatch & Palette::getSwatchForTarget(int handle) const {
+        if (handle < 0 || static_cast<size_t>(handle) >= this->selectedSwatches.size()) {
+            return INVALID_SWATCH;
+        }
+        return this->selectedSwatches[handle];
+    }
+
+    const Swatch & Palette::getDominantSwatch() const {
         return this->dominantSwatch;
     }
 
-    Colour Palette::getVibrantColour(const Colour & c) {
-        return this->getColourForTarget(Target::VIBRANT, c);
+    Colour Palette::getVibrantColour(const Colour & c) const {
+        return this->getColourForTarget(this->targets.getDefaultHandle(Target::Default::Vibrant), c);
     }
 
-    Colour Palette::getLightVibrantColour(const Colour & c) {
-        return this->getColourForTarget(Target::LIGHT_VIBRANT, c);
+    Colour Palette::getLightVibrantColour(const Colour & c) const {
+        return this->getColourForTarget(this->targets.getDefaultHandle(Target::Default::LightVibrant), c);
     }
 
-    Colour Palette::getDarkVibrantColour(const Colour & c) {
-        return this->getColourForTarget(Target::DARK_VIBRANT, c);
+    Colour Palette::getDarkVibrantColour(const Colour & c) const {
+        return this->getColourForTarget(this->targets.getDefaultHandle(Target::Default::DarkVibrant), c);
     }
 
-    Colour Palette::getMutedColour(const Colour & c) {
-        return this->getColourForTarget(Target::MUTED, c);
+    Colour Palette::getMutedColour(const Colour & c) const {
+        return this->getColourForTarget(this->targets.getDefaultHandle(Target::Default::Muted), c);
     }
 
-    Colour Palette::getLightMutedColour(const Colour & c) {
-        return this->getColourForTarget(Target::LIGHT_MUTED, c);
+    Colour Palette::getLightMutedColour(const Colour & c) const {
+        return this->getColourForTarget(this->targets.getDefaultHandle(Target::Default::LightMuted), c);
     }
 
-    Colour Palette::getDarkMutedColour(const Colour & c) {
-        return this->getColourForTarget(Target::DARK_MUTED, c);
+    Colour Palette::getDarkMutedColour(const Colour & c) const {
+        return this->getColourForTarget(this->targets.getDefaultHandle(Target::Default::DarkMuted), c);
+    }
+
+    Colour Palette::getColourForTarget(const Target::Target & t, const Colour & c) const {
+        const Swatch & swatch = this->getSwatchForTarget(t);
+        return (swatch.isValid() ? swatch.getColour() : c);
     }
 
-    Colour Palette::getColourForTarget(const Target::Target & t, const Colour & c) {
-        Swatch swatch = this->getSwatchForTarget(t);
+    Colour Palette::getColourForTarget(int handle, const Colour & c) const {
+        const Swatch & swatch = this->getSwatchForTarget(handle);
         return (swatch.isValid() ? swatch.getColour() : c);
     }
 
-    Colour Palette::getDominantColour(const Colour & c) {
+    Colour Palette::getDominantColour(const Colour & c) const {
         return (this->dominantSwatch.isValid() ? this->dominantSwatch.getColour() : c);
     }
 
-    Palette::Builder::Builder(const Bitmap & b) {
+    // Count the pixels into the workspace, scaling them down by the ratio if it's positive
+    // The region is scaled while it is being counted so no scaled copy is made.
+    static void count(const BitmapView & pixels, double scaleRatio, size_t threads, QuantizerWorkspace & ws, int bits) {
+        ws.setWordWidth(bits);
+        if (scaleRatio > 0) {
+            size_t width = std::ceil(pixels.getWidth() * scaleRatio);
+            size_t height = std::ceil(pixels.getHeight() * scaleRatio);
+            Histogram::countScaled(pixels, width, height, threads, ws);
+
+        // Otherwise read the original pixels in place
+        } else {
+            Histogram::count(pixels, threads, ws);
+        }
+    }
+
+    // Reduce the colours counted in the workspace to each number of colours using the given quantizer
+    // (refining the results if any iterations are given), then clear the workspace
+    static std::vector< std::vector<Swatch> > quantize(Quantizer & quantizer, const std::vector<int> & counts, std::vector<Filter::Filter *> & filters, size_t threads, QuantizerWorkspace & ws, int iterations, double budget) {
+        // Only colours which the filters allow are passed on
+        std::shared_ptr<const Filter::FilterMask> mask = Filter::FilterMask::get(filters, ws.getWordWidth());
+        Histogram::filter(ws, *mask);
+        std::vector< std::vector<Swatch> > swatches = quantizer.quantizeEach(ws, counts, mask, threads);
+        for (size_t i = 0; i < swatches.size() && iterations > 0; i++) {
+            swatches[i] = KMeans::refine(ws, swatches[i], *mask, iterations, budget);
+        }
+
+        // Leave the workspace ready for next time
+        Histogram::clear(ws);
+        return swatches;
+    }
+
+    Palette::Builder::Builder(const BitmapView & b) {
         // Initialize members
         this->bitmap = b;
         this->filters.push_back(new Filter::Default());
@@ -209,14 +243,19 @@ namespace Splash {
 
         this->maxColours = DEFAULT_CALCULATE_NUMBER_COLORS;
         this->resizeArea = DEFAULT_RESIZE_BITMAP_AREA;
+        this->threads = 1;
+        this->quantizer = Quantizer::get("ColourCut");
+        this->workspace = nullptr;
+        this->bitsPerComponent = Histogram::WORD_WIDTH;
+        this->refineIterations = 0;
+        this->refineBudget = 0;
 
         // Add default targets
-        this->targets.push_back(Target::VIBRANT);
-        this->targets.push_back(Target::LIGHT_VIBRANT);
-        this->targets.push_back(Target::DARK_VIBRANT);
-        this->targets.push_back(Target::MUTED);
-        this->targets.push_back(Target::LIGHT_MUTED);
-        this->targets.push_back(Target::DARK_MUTED);
+        this->targets = Target::TargetSet::defaults();
+    }
+
+    Palette::Builder::Builder(const ColourHistogram & h) : Builder(BitmapView()) {
+        this->histogram = std::make_shared<const ColourHistogram>(h);
     }
 
     Palette::Builder::Builder(const std::vector<Swatch> & s) {
@@ -224,29 +263,18 @@ namespace Splash {
         this->swatches = s;
     }
 
-    std::vector<Colour> Palette::Builder::getPixelsFromBitmap(const Bitmap & bitmap) {
-        auto v = bitmap.getPixels(this->region.x1, this->region.y1, this->region.x2 - this->region.x1, this->region.y2 - this->region.y1);
-        return v;
-    }
-
-    Bitmap Palette::Builder::scaleBitmapDown(const Bitmap & oldB) {
+    double Palette::Builder::getScaleRatio() {
         double scaleRatio = -1;
 
         // If resizeArea is set
         if (this->resizeArea > 0) {
-            size_t bitmapArea = oldB.getWidth() * oldB.getHeight();
+            size_t bitmapArea = this->bitmap.getWidth() * this->bitmap.getHeight();
             if (bitmapArea > this->resizeArea) {
                 scaleRatio = std::sqrt(this->resizeArea/(double)bitmapArea);
             }
         }
 
-        // Return same bitmap if scaling isn't needed
-        if (scaleRatio <= 0) {
-            return oldB;
-        }
-
-        // Otherwise return scaled bitmap
-        return oldB.createScaledBitmap(std::ceil(oldB.getWidth() * scaleRatio), std::ceil(oldB.getHeight() * scaleRatio));
+        return scaleRatio;
     }
 
     Palette::Builder & Palette::Builder::setMaximumColourCount(const size_t count) {
@@ -259,6 +287,42 @@ namespace Splash {
         return *this;
     }
 
+    Palette::Builder & Palette::Builder::setThreadCount(const size_t count) {
+        this->threads = (count == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : count);
+        return *this;
+    }
+
+    Palette::Builder & Palette::Builder::setQuantizer(const std::string & name) {
+        std::shared_ptr<Quantizer> q = Quantizer::get(name);
+        if (q != nullptr) {
+            this->quantizer = q;
+        }
+        return *this;
+    }
+
+    Palette::Builder & Palette::Builder::setQuantizer(const std::shared_ptr<Quantizer> & q) {
+        if (q != nullptr) {
+            this->quantizer = q;
+        }
+        return *this;
+    }
+
+    Palette::Builder & Palette::Builder::setWorkspace(QuantizerWorkspace * ws) {
+        this->workspace = ws;
+        return *this;
+    }
+
+    Palette::Builder & Palette::Builder::setBitsPerComponent(const int bits) {
+        this->bitsPerComponent = std::min(std::max(bits, Histogram::MIN_WORD_WIDTH), Histogram::MAX_WORD_WIDTH);
+        return *this;
+    }
+
+    Palette::Builder & Palette::Builder::setRefinement(const int iterations, const double budget) {
+        this->refineIterations = std::max(iterations, 0);
+        this->refineBudget = std::max(budget, 0.0);
+        return *this;
+    }
+
     Palette::Builder & Palette::Builder::clearFilters() {
         this->filters.clear();
         return *this;
@@ -285,9 +349,12 @@ namespace Splash {
     }
 
     Palette::Builder & Palette::Builder::addTarget(const Target::Target & t) {
-        if (std::find(this->targets.begin(), this->targets.end(), t) == this->targets.end()) {
-            this->targets.push_back(t);
-        }
+        this->targets.add(t);
+        return *this;
+    }
+
+    Palette::Builder & Palette::Builder::setTargets(const Target::TargetSet & t) {
+        this->targets = t;
         return *this;
     }
 
@@ -296,37 +363,59 @@ namespace Splash {
         return *this;
     }
 
-    std::shared_ptr<Palette> Palette::Builder::generate() {
-        std::vector<Swatch> sws;
+    Palette Palette::Builder::generate() {
+        Palette palette;
+        this->generate(palette);
+        return palette;
+    }
+
+    void Palette::Builder::generate(Palette & palette) {
+        std::vector< std::vector<Swatch> > sws = this->generateSwatches(std::vector<size_t>{this->maxColours});
+        palette.generate(sws[0], this->targets);
+    }
+
+    std::vector<Palette> Palette::Builder::generate(const std::vector<size_t> & counts) {
+        std::vector<Palette> palettes;
+        this->generate(counts, palettes);
+        return palettes;
+    }
+
+    void Palette::Builder::generate(const std::vector<size_t> & counts, std::vector<Palette> & palettes) {
+        std::vector< std::vector<Swatch> > sws = this->generateSwatches(counts);
+        palettes.resize(sws.size());
+        for (size_t i = 0; i < sws.size(); i++) {
+            palettes[i].generate(sws[i], this->targets);
+        }
+    }
+
+    std::vector< std::vector<Swatch> > Palette::Builder::generateSwatches(const std::vector<size_t> & counts) {
+        std::vector< std::vector<Swatch> > sws;
 
         // If we have a bitmap use quantization to reduce the number of colours
         if (this->swatches.empty()) {
-            // Scale bitmap down if needed
-            Bitmap bmap = scaleBitmapDown(this->bitmap);
-
-            // Scale down the region if the bitmap was scaled
-            if (bmap.getWidth() != this->bitmap.getWidth() || bmap.getHeight() != this->bitmap.getHeight()) {
-                double scale = bmap.getWidth() / (double)this->bitmap.getWidth();
-                this->region.x1 = std::floor(this->region.x1 * scale);
-                this->region.y1 = std::floor(this->region.y1 * scale);
-                this->region.x2 = std::min((size_t)std::ceil(this->region.x2 * scale), bmap.getWidth());
-                this->region.y2 = std::min((size_t)std::ceil(this->region.y2 * scale), bmap.getHeight());
+            // Only the region's pixels are read (cropping doesn't copy)
+            Region r = this->region;
+            r.x1 = std::min(r.x1, r.x2);
+            r.y1 = std::min(r.y1, r.y2);
+            BitmapView pixels = this->bitmap.crop(r.x1, r.y1, r.x2 - r.x1, r.y2 - r.y1);
+
+            // Scale down if the bitmap is too large (the ratio is based on the whole bitmap)
+            QuantizerWorkspace & ws = (this->workspace != nullptr ? *this->workspace : QuantizerWorkspace::local());
+            if (this->histogram != nullptr) {
+                this->histogram->addTo(ws);
+            } else {
+                count(pixels, this->getScaleRatio(), this->threads, ws, this->bitsPerComponent);
             }
 
-            // Now generate swatches
-            std::vector<Colour> pixels = this->getPixelsFromBitmap(bmap);
-            ColourCutQuantizer quantizer = ColourCutQuantizer(pixels, this->maxColours, this->filters);
-            sws = quantizer.getQuantizedColours();
+            std::vector<int> maxColours(counts.begin(), counts.end());
+            sws = quantize(*this->quantizer, maxColours, this->filters, this->threads, ws, this->refineIterations, this->refineBudget);
 
         // Otherwise use provided swatches
         } else {
-            sws = this->swatches;
+            sws.assign(counts.size(), this->swatches);
         }
 
-        // Create Palette using swatches
-        std::shared_ptr<Palette> p = std::shared_ptr<Palette>(new Palette(sws, this->targets));
-        p->generate();
-        return p;
+        return sws;
     }
 
     Palette::Builder::~Builder() {
@@ -335,7 +424,11 @@ namespace Splash {
         }
     }
 
-    Palette::Builder Palette::from(const Bitmap & b) {
+    Palette::Builder Palette::from(const BitmapView & b) {
         return Builder(b);
     }
+
+    Palette::Builder Palette::from(const ColourHistogram & h) {
+        return Builder(h);
+    }
 };
\ No newline at end of file
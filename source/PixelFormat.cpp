@@ -0,0 +1,56 @@
+#include "splash/PixelFormat.hpp"
+
+namespace Splash {
+    // Converts a row using the reader for the given format
+    template <PixelFormat F>
+    static void convertRowAs(const unsigned char * src, size_t count, Colour * dst) {
+        int a, r, g, b;
+        for (size_t i = 0; i < count; i++) {
+            PixelReader<F>::read(src + (i * PixelReader<F>::size), a, r, g, b);
+            dst[i].setRaw(((unsigned int)a << 24) | (r << 16) | (g << 8) | b);
+        }
+    }
+
+    size_t bytesPerPixel(PixelFormat f) {
+        switch (f) {
+            case PixelFormat::ARGB8888:
+            case PixelFormat::RGBA8888:
+            case PixelFormat::BGRA8888:
+                return 4;
+
+            case PixelFormat::RGB888:
+                return 3;
+
+            case PixelFormat::RGB565:
+                return 2;
+        }
+
+        // Never reached
+        return 0;
+    }
+
+    void convertRow(const void * src, PixelFormat f, size_t count, Colour * dst) {
+        const unsigned char * p = static_cast<const unsigned char *>(src);
+        switch (f) {
+            case PixelFormat::ARGB8888:
+                convertRowAs<PixelFormat::ARGB8888>(p, count, dst);
+                break;
+
+            case PixelFormat::RGBA8888:
+                convertRowAs<PixelFormat::RGBA8888>(p, count, dst);
+                break;
+
+            case PixelFormat::BGRA8888:
+                convertRowAs<PixelFormat::BGRA8888>(p, count, dst);
+                break;
+
+            case PixelFormat::RGB888:
+                convertRowAs<PixelFormat::RGB888>(p, count, dst);
+                break;
+
+            case PixelFormat::RGB565:
+                convertRowAs<PixelFormat::RGB565>(p, count, dst);
+                break;
+        }
+    }
+};
\ No newline at end of file
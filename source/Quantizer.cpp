@@ -0,0 +1,103 @@
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/OctreeQuantizer.hpp"
+#include "splash/Quantizer.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/SplitTree.hpp"
+#include "splash/WuQuantizer.hpp"
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace Splash {
+    // Quantizers wrapping the built in algorithms
+    class ColourCutEngine : public Quantizer {
+        public:
+            std::vector<Swatch> quantize(QuantizerWorkspace & ws, int maxColours, const std::shared_ptr<const Filter::FilterMask> & mask, size_t threads) {
+                return ColourCutQuantizer(ws, maxColours, mask, threads).getQuantizedColours();
+            }
+
+            std::vector< std::vector<Swatch> > quantizeEach(QuantizerWorkspace & ws, const std::vector<int> & counts, const std::shared_ptr<const Filter::FilterMask> & mask, size_t threads) {
+                std::vector< std::vector<Swatch> > palettes;
+                if (counts.empty()) {
+                    return palettes;
+                }
+
+                // A tree is only worth building when it'll be cut more than once
+                if (counts.size() == 1) {
+                    palettes.push_back(this->quantize(ws, counts[0], mask, threads));
+                    return palettes;
+                }
+
+                SplitTree tree = SplitTree(ws, *std::max_element(counts.begin(), counts.end()), mask, threads);
+                for (size_t i = 0; i < counts.size(); i++) {
+                    palettes.push_back(tree.getQuantizedColours(counts[i]));
+                }
+                return palettes;
+            }
+    };
+
+    class WuEngine : public Quantizer {
+        public:
+            std::vector<Swatch> quantize(QuantizerWorkspace & ws, int maxColours, const std::shared_ptr<const Filter::FilterMask> & mask, size_t) {
+                return WuQuantizer(ws, maxColours, mask).getQuantizedColours();
+            }
+    };
+
+    // The octree is fed the counted colours rather than the pixels
+    class OctreeEngine : public Quantizer {
+        public:
+            std::vector<Swatch> quantize(QuantizerWorkspace & ws, int maxColours, const std::shared_ptr<const Filter::FilterMask> & mask, size_t) {
+                OctreeQuantizer octree = OctreeQuantizer(maxColours, mask);
+                for (size_t i = 0; i < ws.colours.size(); i++) {
+                    octree.add(Histogram::colour(ws.colours[i], ws.getWordWidth()), ws.histogram[ws.colours[i]]);
+                }
+                return octree.getQuantizedColours();
+            }
+    };
+
+    // Registered quantizers keyed by name, starting with the built in ones
+    static std::map< std::string, std::shared_ptr<Quantizer> > & registry() {
+        static std::map< std::string, std::shared_ptr<Quantizer> > quantizers = {
+            {"ColourCut", std::make_shared<ColourCutEngine>()},
+            {"Octree", std::make_shared<OctreeEngine>()},
+            {"Wu", std::make_shared<WuEngine>()}
+        };
+        return quantizers;
+    }
+    static std::mutex registryMutex;
+
+    Quantizer::~Quantizer() {
+
+    }
+
+    std::vector< std::vector<Swatch> > Quantizer::quantizeEach(QuantizerWorkspace & ws, const std::vector<int> & counts, const std::shared_ptr<const Filter::FilterMask> & mask, size_t threads) {
+        std::vector< std::vector<Swatch> > palettes;
+        for (size_t i = 0; i < counts.size(); i++) {
+            palettes.push_back(this->quantize(ws, counts[i], mask, threads));
+        }
+        return palettes;
+    }
+
+    void Quantizer::add(const std::string & name, const std::shared_ptr<Quantizer> & quantizer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (quantizer != nullptr) {
+            registry()[name] = quantizer;
+        }
+    }
+
+    std::shared_ptr<Quantizer> Quantizer::get(const std::string & name) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::map< std::string, std::shared_ptr<Quantizer> >::iterator it = registry().find(name);
+        return (it != registry().end() ? it->second : nullptr);
+    }
+
+    std::vector<std::string> Quantizer::names() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::vector<std::string> names;
+        for (std::map< std::string, std::shared_ptr<Quantizer> >::iterator it = registry().begin(); it != registry().end(); it++) {
+            names.push_back(it->first);
+        }
+        return names;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "splash/Histogram.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include <algorithm>
+
+namespace Splash {
+    QuantizerWorkspace::QuantizerWorkspace() {
+        this->wordWidth = 0;
+        this->setWordWidth(Histogram::WORD_WIDTH);
+    }
+
+    int QuantizerWorkspace::getWordWidth() const {
+        return this->wordWidth;
+    }
+
+    void QuantizerWorkspace::setWordWidth(int width) {
+        width = std::min(std::max(width, Histogram::MIN_WORD_WIDTH), Histogram::MAX_WORD_WIDTH);
+        if (width == this->wordWidth) {
+            return;
+        }
+
+        this->wordWidth = width;
+        this->histogram.assign(Histogram::size(width), 0);
+        this->compact.assign(Histogram::size(width), 0);
+        this->occupancy.assign(Histogram::size(width)/64, 0);
+    }
+
+    QuantizerWorkspace & QuantizerWorkspace::local() {
+        thread_local QuantizerWorkspace workspace;
+        return workspace;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,612 @@
+#include "splash/Simd.hpp"
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define SPLASH_SIMD_X86
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define SPLASH_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace Splash::Simd {
+    // Instruction set in use
+    static ISA activeISA = detectISA();
+
+    // ===== Scalar ===== //
+    static void accumulateRowScalar(const Colour * pixels, size_t count, uint32_t * acc) {
+        const unsigned char * bytes = reinterpret_cast<const unsigned char *>(pixels);
+        for (size_t i = 0; i < count * 4; i++) {
+            acc[i] += bytes[i];
+        }
+    }
+
+    static void addCountsScalar(const uint64_t * src, size_t count, uint64_t * dst) {
+        for (size_t i = 0; i < count; i++) {
+            dst[i] += src[i];
+        }
+    }
+
+    static void quantizeRowScalar(const uint32_t * pixels, size_t count, uint16_t * indices) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t p = pixels[i];
+            indices[i] = ((p >> 9) & 0x7C00) | ((p >> 6) & 0x3E0) | ((p >> 3) & 0x1F);
+        }
+    }
+
+    // Distances are always summed in the same order so that each implementation gives identical results
+    static void nearestCentroidsScalar(const float * points, size_t count, const float * centroids, size_t k, uint32_t * nearest) {
+        const float * cx = centroids;
+        const float * cy = centroids + k;
+        const float * cz = centroids + (k * 2);
+        for (size_t i = 0; i < count; i++) {
+            const float * p = points + (i * 4);
+            float best = 0;
+            uint32_t index = 0;
+            for (size_t j = 0; j < k; j++) {
+                float dx = cx[j] - p[0];
+                float dy = cy[j] - p[1];
+                float dz = cz[j] - p[2];
+                float d = (dx * dx + dy * dy) + dz * dz;
+                if (j == 0 || d < best) {
+                    best = d;
+                    index = j;
+                }
+            }
+            nearest[i] = index;
+        }
+    }
+
+    // Returns the index of the smallest of the given distances, preferring the lowest index on ties
+    static inline uint32_t pickNearest(const float * dists, const uint32_t * indices, size_t lanes) {
+        size_t best = 0;
+        for (size_t l = 1; l < lanes; l++) {
+            if (dists[l] < dists[best] || (dists[l] == dists[best] && indices[l] < indices[best])) {
+                best = l;
+            }
+        }
+        return indices[best];
+    }
+
+    // Returns the score of a single swatch for the given target (see scoreTargets())
+    // Terms are always summed in the same order so that each implementation gives identical results
+    static inline float scoreSwatch(const float * target, float s, float l, float p) {
+        if (!(s >= target[5] && s <= target[6] && l >= target[7] && l <= target[8])) {
+            return -std::numeric_limits<float>::infinity();
+        }
+        return (target[0] * (1.0f - std::abs(s - target[3])) + target[1] * (1.0f - std::abs(l - target[4]))) + target[2] * p;
+    }
+
+    static void scoreTargetsScalar(const float * swatches, size_t count, const float * targets, size_t numTargets, float * scores) {
+        for (size_t t = 0; t < numTargets; t++) {
+            const float * target = targets + (t * TARGET_SIZE);
+            for (size_t i = 0; i < count; i++) {
+                scores[t * count + i] = scoreSwatch(target, swatches[i], swatches[count + i], swatches[(count * 2) + i]);
+            }
+        }
+    }
+
+#if defined(SPLASH_SIMD_X86)
+    // ===== SSE2 ===== //
+    __attribute__((target("sse2")))
+    static void accumulateRowSSE2(const Colour * pixels, size_t count, uint32_t * acc) {
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+
+        // Four pixels (16 bytes) at a time: widen 8 -> 16 -> 32 bits and add
+        for (; i + 4 <= count; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+            __m128i * a = reinterpret_cast<__m128i *>(acc + (i * 4));
+            _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), _mm_unpacklo_epi16(lo, zero)));
+            _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(lo, zero)));
+            _mm_storeu_si128(a + 2, _mm_add_epi32(_mm_loadu_si128(a + 2), _mm_unpacklo_epi16(hi, zero)));
+            _mm_storeu_si128(a + 3, _mm_add_epi32(_mm_loadu_si128(a + 3), _mm_unpackhi_epi16(hi, zero)));
+        }
+
+        accumulateRowScalar(pixels + i, count - i, acc + (i * 4));
+    }
+
+    __attribute__((target("sse2")))
+    static void addCountsSSE2(const uint64_t * src, size_t count, uint64_t * dst) {
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m128i * d = reinterpret_cast<__m128i *>(dst + i);
+            _mm_storeu_si128(d, _mm_add_epi64(_mm_loadu_si128(d), _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+        }
+
+        addCountsScalar(src + i, count - i, dst + i);
+    }
+
+    // Returns the 15-bit index of each of the four pixels in the vector (as 32-bit values)
+    __attribute__((target("sse2")))
+    static inline __m128i quantizeSSE2(__m128i p) {
+        __m128i r = _mm_and_si128(_mm_srli_epi32(p, 9), _mm_set1_epi32(0x7C00));
+        __m128i g = _mm_and_si128(_mm_srli_epi32(p, 6), _mm_set1_epi32(0x3E0));
+        __m128i b = _mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x1F));
+        return _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+
+    __attribute__((target("sse2")))
+    static void quantizeRowSSE2(const uint32_t * pixels, size_t count, uint16_t * indices) {
+        size_t i = 0;
+
+        // Eight pixels at a time; indices never exceed 0x7FFF so a signed pack is safe
+        for (; i + 8 <= count; i += 8) {
+            __m128i lo = quantizeSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i)));
+            __m128i hi = quantizeSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i + 4)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(indices + i), _mm_packs_epi32(lo, hi));
+        }
+
+        quantizeRowScalar(pixels + i, count - i, indices + i);
+    }
+
+    // Each lane tracks the nearest of the centroids it has seen (every fourth one)
+    __attribute__((target("sse2")))
+    static void nearestCentroidsSSE2(const float * points, size_t count, const float * centroids, size_t k, uint32_t * nearest) {
+        for (size_t i = 0; i < count; i++) {
+            const __m128 px = _mm_set1_ps(points[i * 4]);
+            const __m128 py = _mm_set1_ps(points[i * 4 + 1]);
+            const __m128 pz = _mm_set1_ps(points[i * 4 + 2]);
+            __m128 best = _mm_set1_ps(0);
+            __m128i index = _mm_setzero_si128();
+            __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+            for (size_t j = 0; j < k; j += 4) {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(centroids + j), px);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(centroids + k + j), py);
+                __m128 dz = _mm_sub_ps(_mm_loadu_ps(centroids + (k * 2) + j), pz);
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                __m128 closer = (j == 0 ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : _mm_cmplt_ps(d, best));
+                best = _mm_or_ps(_mm_and_ps(closer, d), _mm_andnot_ps(closer, best));
+                index = _mm_or_si128(_mm_and_si128(_mm_castps_si128(closer), lane), _mm_andnot_si128(_mm_castps_si128(closer), index));
+                lane = _mm_add_epi32(lane, _mm_set1_epi32(4));
+            }
+
+            float dists[4];
+            uint32_t indices[4];
+            _mm_storeu_ps(dists, best);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(indices), index);
+            nearest[i] = pickNearest(dists, indices, 4);
+        }
+    }
+
+    // Four swatches are scored at once, with any left over scored one at a time
+    __attribute__((target("sse2")))
+    static void scoreTargetsSSE2(const float * swatches, size_t count, const float * targets, size_t numTargets, float * scores) {
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 excluded = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+        for (size_t t = 0; t < numTargets; t++) {
+            const float * target = targets + (t * TARGET_SIZE);
+            float * row = scores + (t * count);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128 s = _mm_loadu_ps(swatches + i);
+                __m128 l = _mm_loadu_ps(swatches + count + i);
+                __m128 p = _mm_loadu_ps(swatches + (count * 2) + i);
+                __m128 sScore = _mm_mul_ps(_mm_set1_ps(target[0]), _mm_sub_ps(one, _mm_andnot_ps(sign, _mm_sub_ps(s, _mm_set1_ps(target[3])))));
+                __m128 lScore = _mm_mul_ps(_mm_set1_ps(target[1]), _mm_sub_ps(one, _mm_andnot_ps(sign, _mm_sub_ps(l, _mm_set1_ps(target[4])))));
+                __m128 score = _mm_add_ps(_mm_add_ps(sScore, lScore), _mm_mul_ps(_mm_set1_ps(target[2]), p));
+                __m128 inRange = _mm_and_ps(_mm_cmpge_ps(s, _mm_set1_ps(target[5])), _mm_cmple_ps(s, _mm_set1_ps(target[6])));
+                inRange = _mm_and_ps(inRange, _mm_and_ps(_mm_cmpge_ps(l, _mm_set1_ps(target[7])), _mm_cmple_ps(l, _mm_set1_ps(target[8]))));
+                _mm_storeu_ps(row + i, _mm_or_ps(_mm_and_ps(inRange, score), _mm_andnot_ps(inRange, excluded)));
+            }
+
+            for (; i < count; i++) {
+                row[i] = scoreSwatch(target, swatches[i], swatches[count + i], swatches[(count * 2) + i]);
+            }
+        }
+    }
+
+    // ===== AVX2 ===== //
+    __attribute__((target("avx2")))
+    static void accumulateRowAVX2(const Colour * pixels, size_t count, uint32_t * acc) {
+        size_t i = 0;
+
+        // Eight pixels at a time, two pixels (8 bytes) per 256-bit widening conversion
+        for (; i + 8 <= count; i += 8) {
+            const unsigned char * p = reinterpret_cast<const unsigned char *>(pixels + i);
+            __m256i * a = reinterpret_cast<__m256i *>(acc + (i * 4));
+            for (size_t j = 0; j < 4; j++) {
+                __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + (j * 8))));
+                _mm256_storeu_si256(a + j, _mm256_add_epi32(_mm256_loadu_si256(a + j), v));
+            }
+        }
+
+        accumulateRowSSE2(pixels + i, count - i, acc + (i * 4));
+    }
+
+    __attribute__((target("avx2")))
+    static void addCountsAVX2(const uint64_t * src, size_t count, uint64_t * dst) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i * d = reinterpret_cast<__m256i *>(dst + i);
+            _mm256_storeu_si256(d, _mm256_add_epi64(_mm256_loadu_si256(d), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i))));
+        }
+
+        addCountsSSE2(src + i, count - i, dst + i);
+    }
+
+    // Returns the 15-bit index of each of the eight pixels in the vector (as 32-bit values)
+    __attribute__((target("avx2")))
+    static inline __m256i quantizeAVX2(__m256i p) {
+        __m256i r = _mm256_and_si256(_mm256_srli_epi32(p, 9), _mm256_set1_epi32(0x7C00));
+        __m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 6), _mm256_set1_epi32(0x3E0));
+        __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 3), _mm256_set1_epi32(0x1F));
+        return _mm256_or_si256(_mm256_or_si256(r, g), b);
+    }
+
+    __attribute__((target("avx2")))
+    static void quantizeRowAVX2(const uint32_t * pixels, size_t count, uint16_t * indices) {
+        size_t i = 0;
+
+        // Sixteen pixels at a time; the pack works within 128-bit lanes so the
+        // middle quarters are swapped back afterwards
+        for (; i + 16 <= count; i += 16) {
+            __m256i lo = quantizeAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i)));
+            __m256i hi = quantizeAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i + 8)));
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(indices + i), packed);
+        }
+
+        quantizeRowSSE2(pixels + i, count - i, indices + i);
+    }
+
+    __attribute__((target("avx2")))
+    static void nearestCentroidsAVX2(const float * points, size_t count, const float * centroids, size_t k, uint32_t * nearest) {
+        for (size_t i = 0; i < count; i++) {
+            const __m256 px = _mm256_set1_ps(points[i * 4]);
+            const __m256 py = _mm256_set1_ps(points[i * 4 + 1]);
+            const __m256 pz = _mm256_set1_ps(points[i * 4 + 2]);
+            __m256 best = _mm256_set1_ps(0);
+            __m256i index = _mm256_setzero_si256();
+            __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            for (size_t j = 0; j < k; j += 8) {
+                __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(centroids + j), px);
+                __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(centroids + k + j), py);
+                __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(centroids + (k * 2) + j), pz);
+                __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+                __m256 closer = (j == 0 ? _mm256_castsi256_ps(_mm256_set1_epi32(-1)) : _mm256_cmp_ps(d, best, _CMP_LT_OQ));
+                best = _mm256_blendv_ps(best, d, closer);
+                index = _mm256_blendv_epi8(index, lane, _mm256_castps_si256(closer));
+                lane = _mm256_add_epi32(lane, _mm256_set1_epi32(8));
+            }
+
+            // Find the smallest distance across the lanes, then the lowest index with it
+            __m256 m = _mm256_min_ps(best, _mm256_permute2f128_ps(best, best, 1));
+            m = _mm256_min_ps(m, _mm256_shuffle_ps(m, m, 0x4E));
+            m = _mm256_min_ps(m, _mm256_shuffle_ps(m, m, 0xB1));
+            __m256i candidates = _mm256_blendv_epi8(_mm256_set1_epi32(-1), index, _mm256_castps_si256(_mm256_cmp_ps(best, m, _CMP_EQ_OQ)));
+            candidates = _mm256_min_epu32(candidates, _mm256_permute2x128_si256(candidates, candidates, 1));
+            candidates = _mm256_min_epu32(candidates, _mm256_shuffle_epi32(candidates, 0x4E));
+            candidates = _mm256_min_epu32(candidates, _mm256_shuffle_epi32(candidates, 0xB1));
+            nearest[i] = _mm256_cvtsi256_si32(candidates);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void scoreTargetsAVX2(const float * swatches, size_t count, const float * targets, size_t numTargets, float * scores) {
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 excluded = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+        for (size_t t = 0; t < numTargets; t++) {
+            const float * target = targets + (t * TARGET_SIZE);
+            float * row = scores + (t * count);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 s = _mm256_loadu_ps(swatches + i);
+                __m256 l = _mm256_loadu_ps(swatches + count + i);
+                __m256 p = _mm256_loadu_ps(swatches + (count * 2) + i);
+                __m256 sScore = _mm256_mul_ps(_mm256_set1_ps(target[0]), _mm256_sub_ps(one, _mm256_andnot_ps(sign, _mm256_sub_ps(s, _mm256_set1_ps(target[3])))));
+                __m256 lScore = _mm256_mul_ps(_mm256_set1_ps(target[1]), _mm256_sub_ps(one, _mm256_andnot_ps(sign, _mm256_sub_ps(l, _mm256_set1_ps(target[4])))));
+                __m256 score = _mm256_add_ps(_mm256_add_ps(sScore, lScore), _mm256_mul_ps(_mm256_set1_ps(target[2]), p));
+                __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(s, _mm256_set1_ps(target[5]), _CMP_GE_OQ), _mm256_cmp_ps(s, _mm256_set1_ps(target[6]), _CMP_LE_OQ));
+                inRange = _mm256_and_ps(inRange, _mm256_and_ps(_mm256_cmp_ps(l, _mm256_set1_ps(target[7]), _CMP_GE_OQ), _mm256_cmp_ps(l, _mm256_set1_ps(target[8]), _CMP_LE_OQ)));
+                _mm256_storeu_ps(row + i, _mm256_blendv_ps(excluded, score, inRange));
+            }
+
+            for (; i < count; i++) {
+                row[i] = scoreSwatch(target, swatches[i], swatches[count + i], swatches[(count * 2) + i]);
+            }
+        }
+    }
+#endif
+
+#if defined(SPLASH_SIMD_NEON)
+    // ===== NEON ===== //
+    static void accumulateRowNEON(const Colour * pixels, size_t count, uint32_t * acc) {
+        size_t i = 0;
+
+        // Four pixels (16 bytes) at a time: widen 8 -> 16 bits, then widen while adding
+        for (; i + 4 <= count; i += 4) {
+            uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(pixels + i));
+            uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+            uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+
+            uint32_t * a = acc + (i * 4);
+            vst1q_u32(a, vaddw_u16(vld1q_u32(a), vget_low_u16(lo)));
+            vst1q_u32(a + 4, vaddw_u16(vld1q_u32(a + 4), vget_high_u16(lo)));
+            vst1q_u32(a + 8, vaddw_u16(vld1q_u32(a + 8), vget_low_u16(hi)));
+            vst1q_u32(a + 12, vaddw_u16(vld1q_u32(a + 12), vget_high_u16(hi)));
+        }
+
+        accumulateRowScalar(pixels + i, count - i, acc + (i * 4));
+    }
+
+    static void addCountsNEON(const uint64_t * src, size_t count, uint64_t * dst) {
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            vst1q_u64(dst + i, vaddq_u64(vld1q_u64(dst + i), vld1q_u64(src + i)));
+        }
+
+        addCountsScalar(src + i, count - i, dst + i);
+    }
+
+    static void quantizeRowNEON(const uint32_t * pixels, size_t count, uint16_t * indices) {
+        size_t i = 0;
+
+        // Eight pixels at a time, narrowing each half to 16 bits
+        for (; i + 8 <= count; i += 8) {
+            uint32x4_t p[2] = { vld1q_u32(pixels + i), vld1q_u32(pixels + i + 4) };
+            uint16x4_t out[2];
+            for (size_t j = 0; j < 2; j++) {
+                uint32x4_t r = vandq_u32(vshrq_n_u32(p[j], 9), vdupq_n_u32(0x7C00));
+                uint32x4_t g = vandq_u32(vshrq_n_u32(p[j], 6), vdupq_n_u32(0x3E0));
+                uint32x4_t b = vandq_u32(vshrq_n_u32(p[j], 3), vdupq_n_u32(0x1F));
+                out[j] = vmovn_u32(vorrq_u32(vorrq_u32(r, g), b));
+            }
+            vst1q_u16(indices + i, vcombine_u16(out[0], out[1]));
+        }
+
+        quantizeRowScalar(pixels + i, count - i, indices + i);
+    }
+
+    // Multiplies and adds are kept separate (rather than fused) to match the other implementations
+    static void nearestCentroidsNEON(const float * points, size_t count, const float * centroids, size_t k, uint32_t * nearest) {
+        for (size_t i = 0; i < count; i++) {
+            const float32x4_t px = vdupq_n_f32(points[i * 4]);
+            const float32x4_t py = vdupq_n_f32(points[i * 4 + 1]);
+            const float32x4_t pz = vdupq_n_f32(points[i * 4 + 2]);
+            float32x4_t best = vdupq_n_f32(0);
+            uint32x4_t index = vdupq_n_u32(0);
+            const uint32_t first[4] = {0, 1, 2, 3};
+            uint32x4_t lane = vld1q_u32(first);
+            for (size_t j = 0; j < k; j += 4) {
+                float32x4_t dx = vsubq_f32(vld1q_f32(centroids + j), px);
+                float32x4_t dy = vsubq_f32(vld1q_f32(centroids + k + j), py);
+                float32x4_t dz = vsubq_f32(vld1q_f32(centroids + (k * 2) + j), pz);
+                float32x4_t d = vaddq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)), vmulq_f32(dz, dz));
+                uint32x4_t closer = (j == 0 ? vdupq_n_u32(0xFFFFFFFF) : vcltq_f32(d, best));
+                best = vbslq_f32(closer, d, best);
+                index = vbslq_u32(closer, lane, index);
+                lane = vaddq_u32(lane, vdupq_n_u32(4));
+            }
+
+            float dists[4];
+            uint32_t indices[4];
+            vst1q_f32(dists, best);
+            vst1q_u32(indices, index);
+            nearest[i] = pickNearest(dists, indices, 4);
+        }
+    }
+
+    static void scoreTargetsNEON(const float * swatches, size_t count, const float * targets, size_t numTargets, float * scores) {
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t excluded = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+        for (size_t t = 0; t < numTargets; t++) {
+            const float * target = targets + (t * TARGET_SIZE);
+            float * row = scores + (t * count);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                float32x4_t s = vld1q_f32(swatches + i);
+                float32x4_t l = vld1q_f32(swatches + count + i);
+                float32x4_t p = vld1q_f32(swatches + (count * 2) + i);
+                float32x4_t sScore = vmulq_f32(vdupq_n_f32(target[0]), vsubq_f32(one, vabdq_f32(s, vdupq_n_f32(target[3]))));
+                float32x4_t lScore = vmulq_f32(vdupq_n_f32(target[1]), vsubq_f32(one, vabdq_f32(l, vdupq_n_f32(target[4]))));
+                float32x4_t score = vaddq_f32(vaddq_f32(sScore, lScore), vmulq_f32(vdupq_n_f32(target[2]), p));
+                uint32x4_t inRange = vandq_u32(vcgeq_f32(s, vdupq_n_f32(target[5])), vcleq_f32(s, vdupq_n_f32(target[6])));
+                inRange = vandq_u32(inRange, vandq_u32(vcgeq_f32(l, vdupq_n_f32(target[7])), vcleq_f32(l, vdupq_n_f32(target[8]))));
+                vst1q_f32(row + i, vbslq_f32(inRange, score, excluded));
+            }
+
+            for (; i < count; i++) {
+                row[i] = scoreSwatch(target, swatches[i], swatches[count + i], swatches[(count * 2) + i]);
+            }
+        }
+    }
+#endif
+
+    ISA detectISA() {
+        if (isSupported(ISA::AVX2)) {
+            return ISA::AVX2;
+        } else if (isSupported(ISA::SSE2)) {
+            return ISA::SSE2;
+        } else if (isSupported(ISA::NEON)) {
+            return ISA::NEON;
+        }
+        return ISA::Scalar;
+    }
+
+    bool isSupported(ISA isa) {
+#if defined(SPLASH_SIMD_X86)
+        // Required as this may be called before static constructors have run
+        __builtin_cpu_init();
+#endif
+
+        switch (isa) {
+            case ISA::Scalar:
+                return true;
+
+#if defined(SPLASH_SIMD_X86)
+            case ISA::SSE2:
+                return __builtin_cpu_supports("sse2");
+
+            case ISA::AVX2:
+                return __builtin_cpu_supports("avx2");
+#endif
+
+#if defined(SPLASH_SIMD_NEON)
+            case ISA::NEON:
+                return true;
+#endif
+
+            default:
+                return false;
+        }
+    }
+
+    ISA getISA() {
+        return activeISA;
+    }
+
+    bool setISA(ISA isa) {
+        if (!isSupported(isa)) {
+            return false;
+        }
+
+        activeISA = isa;
+        return true;
+    }
+
+    const char * toString(ISA isa) {
+        switch (isa) {
+            case ISA::Scalar:
+                return "Scalar";
+
+            case ISA::SSE2:
+                return "SSE2";
+
+            case ISA::AVX2:
+                return "AVX2";
+
+            case ISA::NEON:
+                return "NEON";
+        }
+
+        // Never reached
+        return "";
+    }
+
+    void accumulateRow(const Colour * pixels, size_t count, uint32_t * acc) {
+        switch (activeISA) {
+#if defined(SPLASH_SIMD_X86)
+            case ISA::AVX2:
+                accumulateRowAVX2(pixels, count, acc);
+                break;
+
+            case ISA::SSE2:
+                accumulateRowSSE2(pixels, count, acc);
+                break;
+#endif
+
+#if defined(SPLASH_SIMD_NEON)
+            case ISA::NEON:
+                accumulateRowNEON(pixels, count, acc);
+                break;
+#endif
+
+            default:
+                accumulateRowScalar(pixels, count, acc);
+                break;
+        }
+    }
+
+    void addCounts(const uint64_t * src, size_t count, uint64_t * dst) {
+        switch (activeISA) {
+#if defined(SPLASH_SIMD_X86)
+            case ISA::AVX2:
+                addCountsAVX2(src, count, dst);
+                break;
+
+            case ISA::SSE2:
+                addCountsSSE2(src, count, dst);
+                break;
+#endif
+
+#if defined(SPLASH_SIMD_NEON)
+            case ISA::NEON:
+                addCountsNEON(src, count, dst);
+                break;
+#endif
+
+            default:
+                addCountsScalar(src, count, dst);
+                break;
+        }
+    }
+
+    void quantizeRow(const uint32_t * pixels, size_t count, uint16_t * indices) {
+        switch (activeISA) {
+#if defined(SPLASH_SIMD_X86)
+            case ISA::AVX2:
+                quantizeRowAVX2(pixels, count, indices);
+                break;
+
+            case ISA::SSE2:
+                quantizeRowSSE2(pixels, count, indices);
+                break;
+#endif
+
+#if defined(SPLASH_SIMD_NEON)
+            case ISA::NEON:
+                quantizeRowNEON(pixels, count, indices);
+                break;
+#endif
+
+            default:
+                quantizeRowScalar(pixels, count, indices);
+                break;
+        }
+    }
+
+    void nearestCentroids(const float * points, size_t count, const float * centroids, size_t k, uint32_t * nearest) {
+        switch (activeISA) {
+#if defined(SPLASH_SIMD_X86)
+            case ISA::AVX2:
+                nearestCentroidsAVX2(points, count, centroids, k, nearest);
+                break;
+
+            case ISA::SSE2:
+                nearestCentroidsSSE2(points, count, centroids, k, nearest);
+                break;
+#endif
+
+#if defined(SPLASH_SIMD_NEON)
+            case ISA::NEON:
+                nearestCentroidsNEON(points, count, centroids, k, nearest);
+                break;
+#endif
+
+            default:
+                nearestCentroidsScalar(points, count, centroids, k, nearest);
+                break;
+        }
+    }
+
+    void scoreTargets(const float * swatches, size_t count, const float * targets, size_t numTargets, float * scores) {
+        switch (activeISA) {
+#if defined(SPLASH_SIMD_X86)
+            case ISA::AVX2:
+                scoreTargetsAVX2(swatches, count, targets, numTargets, scores);
+                break;
+
+            case ISA::SSE2:
+                scoreTargetsSSE2(swatches, count, targets, numTargets, scores);
+                break;
+#endif
+
+#if defined(SPLASH_SIMD_NEON)
+            case ISA::NEON:
+                scoreTargetsNEON(swatches, count, targets, numTargets, scores);
+                break;
+#endif
+
+            default:
+                scoreTargetsScalar(swatches, count, targets, numTargets, scores);
+                break;
+        }
+    }
+};
\ No newline at end of file
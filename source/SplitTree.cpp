@@ -0,0 +1,179 @@
+#include "splash/Histogram.hpp"
+#include "splash/SplitTree.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace Splash {
+    SplitTree::SplitTree(const BitmapView & pixels, int maxColours, std::vector<Filter::Filter *> & filters, size_t threads, int wordWidth) : owned(new QuantizerWorkspace()), workspace(*owned) {
+        this->workspace.setWordWidth(wordWidth);
+        this->threads = threads;
+
+        // Count and filter the colours once, keeping them in the tree's workspace
+        Histogram::count(pixels, threads, this->workspace);
+        this->mask = Filter::FilterMask::get(filters, this->workspace.getWordWidth());
+        Histogram::filter(this->workspace, *this->mask);
+        this->build(maxColours);
+    }
+
+    SplitTree::SplitTree(QuantizerWorkspace & ws, int maxColours, const std::shared_ptr<const Filter::FilterMask> & mask, size_t threads) : workspace(ws) {
+        this->threads = threads;
+        this->mask = mask;
+        this->build(maxColours);
+    }
+
+    void SplitTree::build(int maxColours) {
+        this->stopped = false;
+        if (this->workspace.colours.empty()) {
+            return;
+        }
+
+        // The root holds every colour
+        ColourCutQuantizer quantizer = ColourCutQuantizer(this->workspace, this->mask, this->threads);
+        ColourCutQuantizer::Vbox root = ColourCutQuantizer::Vbox(0, this->workspace.colours.size() - 1);
+        Swatch swatch;
+        switch (this->workspace.getWordWidth()) {
+            case 4:
+                quantizer.fitBox<4>(root);
+                swatch = quantizer.getAverageColour<4>(root);
+                break;
+
+            case 5:
+                quantizer.fitBox<5>(root);
+                swatch = quantizer.getAverageColour<5>(root);
+                break;
+
+            case 6:
+                quantizer.fitBox<6>(root);
+                swatch = quantizer.getAverageColour<6>(root);
+                break;
+        }
+        this->heap.push_back(root);
+        this->boxes.push_back(root);
+        this->nodes.push_back(Node{swatch, -1, -1});
+        this->leaves.assign(this->workspace.colours.size(), -1);
+        this->leaves[0] = 0;
+        this->grow(maxColours);
+    }
+
+    void SplitTree::grow(int maxColours) {
+        switch (this->workspace.getWordWidth()) {
+            case 4:
+                this->grow<4>(maxColours);
+                break;
+
+            case 5:
+                this->grow<5>(maxColours);
+                break;
+
+            case 6:
+                this->grow<6>(maxColours);
+                break;
+        }
+    }
+
+    template <int W>
+    void SplitTree::grow(int maxColours) {
+        if (this->stopped || (int)this->heap.size() >= maxColours) {
+            return;
+        }
+
+        ColourCutQuantizer quantizer = ColourCutQuantizer(this->workspace, this->mask, this->threads);
+        this->history.clear();
+        quantizer.splitBoxes<W>(this->heap, maxColours, &this->history);
+        this->stopped = ((int)this->heap.size() < maxColours);
+
+        // Add the halves of each split to the tree
+        for (size_t i = 0; i < this->history.size(); i++) {
+            int parent = this->leaves[this->history[i].box.lowerIndex];
+            this->splits.push_back(parent);
+
+            const ColourCutQuantizer::Vbox halves[2] = {this->history[i].lower, this->history[i].upper};
+            for (size_t h = 0; h < 2; h++) {
+                int index = this->nodes.size();
+                (h == 0 ? this->nodes[parent].lower : this->nodes[parent].upper) = index;
+                this->boxes.push_back(halves[h]);
+                this->nodes.push_back(Node{quantizer.getAverageColour<W>(halves[h]), -1, -1});
+                this->leaves[halves[h].lowerIndex] = index;
+            }
+        }
+    }
+
+    template <int W>
+    std::vector<Swatch> SplitTree::cut(int maxColours) const {
+        std::vector<Swatch> swatches;
+        const std::vector<uint32_t> & colours = this->workspace.colours;
+        const std::vector<int64_t> & histogram = this->workspace.histogram;
+
+        // If there are fewer colours than requested they're used as is (in ascending order)
+        if ((int)colours.size() <= maxColours) {
+            std::vector<uint32_t> sorted = colours;
+            std::sort(sorted.begin(), sorted.end());
+            for (size_t i = 0; i < sorted.size(); i++) {
+                Colour c = Colour();
+                c.setRaw(ColourCutQuantizer::approximateToRGB888<W>(sorted[i]));
+                swatches.push_back(Swatch(c, histogram[sorted[i]]));
+            }
+            return swatches;
+        }
+
+        // Replay the heap using the recorded splits, which leaves the boxes in the same
+        // order as when they were split for this many colours
+        std::function<bool(int, int)> comp = [this](int a, int b) {
+            return ColourCutQuantizer::VBOX_COMP(this->boxes[a], this->boxes[b]);
+        };
+        std::vector<int> heap = {0};
+        for (int i = 0; i + 1 < maxColours && !heap.empty(); i++) {
+            std::pop_heap(heap.begin(), heap.end(), comp);
+            int node = heap.back();
+            heap.pop_back();
+
+            // A box which couldn't be split is dropped, and splitting stops
+            if (i >= (int)this->splits.size()) {
+                break;
+            }
+            heap.push_back(this->nodes[node].upper);
+            std::push_heap(heap.begin(), heap.end(), comp);
+            heap.push_back(this->nodes[node].lower);
+            std::push_heap(heap.begin(), heap.end(), comp);
+        }
+
+        // Boxes are taken from the heap in order of volume (largest first), skipping averages which aren't allowed
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), comp);
+            const Swatch & swatch = this->nodes[heap.back()].swatch;
+            heap.pop_back();
+            if (this->mask->isAllowed(Histogram::quantize(swatch.getColour(), W))) {
+                swatches.push_back(swatch);
+            }
+        }
+        return swatches;
+    }
+
+    std::vector<Swatch> SplitTree::getQuantizedColours(int maxColours) {
+        if (this->nodes.empty()) {
+            return std::vector<Swatch>();
+        }
+        if ((int)this->splits.size() + 1 < maxColours) {
+            this->grow(maxColours);
+        }
+
+        switch (this->workspace.getWordWidth()) {
+            case 4:
+                return this->cut<4>(maxColours);
+
+            case 6:
+                return this->cut<6>(maxColours);
+
+            default:
+                return this->cut<5>(maxColours);
+        }
+    }
+
+    const std::vector<SplitTree::Node> & SplitTree::getNodes() const {
+        return this->nodes;
+    }
+
+    const std::vector<int> & SplitTree::getSplits() const {
+        return this->splits;
+    }
+};
\ No newline at end of file
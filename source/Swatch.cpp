@@ -12,13 +12,16 @@ namespace Splash {
     static Colour COLOUR_BLACK = Colour(255, 0, 0, 0);
     static Colour COLOUR_WHITE = Colour(255, 255, 255, 255);
 
-    void Swatch::generateColours() {
+    void Swatch::generateColours() const {
         if (!this->coloursGenerated) {
             this->coloursGenerated = true;
 
+            // ColourUtils takes references, so work on a copy of the colour
+            Colour colour = this->colour;
+
             // Check light colours first
-            int lightBodyAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_WHITE, this->colour, MIN_CONTRAST_BODY_TEXT);
-            int lightTitleAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_WHITE, this->colour, MIN_CONTRAST_TITLE_TEXT);
+            int lightBodyAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_WHITE, colour, MIN_CONTRAST_BODY_TEXT);
+            int lightTitleAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_WHITE, colour, MIN_CONTRAST_TITLE_TEXT);
 
             // If there are valid light values, use those
             if (lightBodyAlpha != -1 && lightTitleAlpha != -1) {
@@ -30,8 +33,8 @@ namespace Splash {
             }
 
             // Check dark colours next
-            int darkBodyAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_BLACK, this->colour, MIN_CONTRAST_BODY_TEXT);
-            int darkTitleAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_BLACK, this->colour, MIN_CONTRAST_TITLE_TEXT);
+            int darkBodyAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_BLACK, colour, MIN_CONTRAST_BODY_TEXT);
+            int darkTitleAlpha = ColourUtils::calculateMinimumAlpha(COLOUR_BLACK, colour, MIN_CONTRAST_TITLE_TEXT);
 
             // If there are valid dark values, use those
             if (darkBodyAlpha != -1 && darkTitleAlpha != -1) {
@@ -64,7 +67,7 @@ namespace Splash {
         this->valid = false;
     }
 
-    Swatch::Swatch(Colour c, int pop) {
+    Swatch::Swatch(Colour c, int64_t pop) {
         this->colour = c;
         this->colour.setA(255);
         this->population = pop;
@@ -80,21 +83,21 @@ namespace Splash {
         return this->colour;
     }
 
-    int Swatch::getPopulation() const {
+    int64_t Swatch::getPopulation() const {
         return this->population;
     }
 
-    Colour Swatch::getTitleTextColour() {
+    Colour Swatch::getTitleTextColour() const {
         this->generateColours();
         return this->titleTextColour;
     }
 
-    Colour Swatch::getBodyTextColour() {
+    Colour Swatch::getBodyTextColour() const {
         this->generateColours();
         return this->bodyTextColour;
     }
 
-    std::string Swatch::toString() {
+    std::string Swatch::toString() const {
         this->generateColours();
         HSL hsl = this->colour.hsl();
         std::string str = "[RGB: #" + Utils::intToHexString(this->colour.raw()) + "] ";
@@ -0,0 +1,84 @@
+#include "splash/WorkerPool.hpp"
+
+namespace Splash {
+    WorkerPool::WorkerPool() {
+        this->job = nullptr;
+        this->parts = 0;
+        this->remaining = 0;
+        this->generation = 0;
+        this->stopping = false;
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->wake.notify_all();
+        for (size_t i = 0; i < this->threads.size(); i++) {
+            this->threads[i].join();
+        }
+    }
+
+    size_t WorkerPool::size() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->threads.size();
+    }
+
+    void WorkerPool::work(size_t part) {
+        // Threads are started for the current job, so begin one generation behind it
+        std::unique_lock<std::mutex> lock(this->mutex);
+        size_t seen = this->generation - 1;
+        while (true) {
+            this->wake.wait(lock, [this, seen]() {
+                return (this->stopping || this->generation != seen);
+            });
+            if (this->stopping) {
+                return;
+            }
+            seen = this->generation;
+
+            // Jobs split into fewer parts leave the later threads waiting
+            if (part < this->parts) {
+                const std::function<void(size_t)> & job = *this->job;
+                lock.unlock();
+                job(part);
+                lock.lock();
+                this->remaining--;
+                if (this->remaining == 0) {
+                    this->finished.notify_one();
+                }
+            }
+        }
+    }
+
+    void WorkerPool::run(size_t parts, const std::function<void(size_t)> & job) {
+        if (parts == 0) {
+            return;
+        }
+        if (parts == 1) {
+            job(0);
+            return;
+        }
+
+        // Hand the job to the threads, starting any more that are needed
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->job = &job;
+            this->parts = parts;
+            this->remaining = parts - 1;
+            this->generation++;
+            while (this->threads.size() < parts - 1) {
+                this->threads.push_back(std::thread(&WorkerPool::work, this, this->threads.size() + 1));
+            }
+        }
+        this->wake.notify_all();
+
+        // The calling thread takes the first part, then waits for the others
+        job(0);
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->finished.wait(lock, [this]() {
+            return (this->remaining == 0);
+        });
+    }
+};
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "splash/Histogram.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/WuQuantizer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Splash {
+    // Returns the number of cells along each side of a moment table for W bits per component
+    template <int W>
+    static constexpr int tableSide() {
+        return (1 << W) + 1;
+    }
+
+    // Returns the index into a moment table of the given position
+    template <int W>
+    static inline size_t tableIndex(int r, int g, int b) {
+        return (((r * tableSide<W>()) + g) * tableSide<W>()) + b;
+    }
+
+    // Sums the moment table at each corner of the box, adding or subtracting so
+    // that only the box's contents remain
+    template <int W, typename T>
+    static T boxSum(int r0, int r1, int g0, int g1, int b0, int b1, const std::vector<T> & m) {
+        return m[tableIndex<W>(r1, g1, b1)] - m[tableIndex<W>(r1, g1, b0)] - m[tableIndex<W>(r1, g0, b1)] + m[tableIndex<W>(r1, g0, b0)]
+             - m[tableIndex<W>(r0, g1, b1)] + m[tableIndex<W>(r0, g1, b0)] + m[tableIndex<W>(r0, g0, b1)] - m[tableIndex<W>(r0, g0, b0)];
+    }
+
+    WuQuantizer::WuQuantizer(const BitmapView & pixels, int maxColours, std::vector<Filter::Filter *> & fs, size_t threads, QuantizerWorkspace * ws, int wordWidth) : workspace(ws != nullptr ? *ws : QuantizerWorkspace::local()), histogram(workspace.histogram), colours(workspace.colours), weights(workspace.weights), momentsR(workspace.momentsR), momentsG(workspace.momentsG), momentsB(workspace.momentsB), moments2(workspace.moments2) {
+        this->filters = fs;
+        this->workspace.setWordWidth(wordWidth);
+        Histogram::count(pixels, threads, this->workspace);
+        this->quantizeHistogram(maxColours);
+    }
+
+    WuQuantizer::WuQuantizer(const BitmapView & pixels, size_t width, size_t height, int maxColours, std::vector<Filter::Filter *> & fs, size_t threads, QuantizerWorkspace * ws, int wordWidth) : workspace(ws != nullptr ? *ws : QuantizerWorkspace::local()), histogram(workspace.histogram), colours(workspace.colours), weights(workspace.weights), momentsR(workspace.momentsR), momentsG(workspace.momentsG), momentsB(workspace.momentsB), moments2(workspace.moments2) {
+        this->filters = fs;
+        this->workspace.setWordWidth(wordWidth);
+        Histogram::countScaled(pixels, width, height, threads, this->workspace);
+        this->quantizeHistogram(maxColours);
+    }
+
+    WuQuantizer::WuQuantizer(QuantizerWorkspace & ws, int maxColours, const std::shared_ptr<const Filter::FilterMask> & m) : workspace(ws), histogram(workspace.histogram), colours(workspace.colours), weights(workspace.weights), momentsR(workspace.momentsR), momentsG(workspace.momentsG), momentsB(workspace.momentsB), moments2(workspace.moments2) {
+        this->mask = m;
+        this->reduceColours(maxColours);
+    }
+
+    void WuQuantizer::quantizeHistogram(int maxColours) {
+        // Remove any colours that the filters don't allow, and list those that remain
+        this->mask = Filter::FilterMask::get(this->filters, this->workspace.getWordWidth());
+        Histogram::filter(this->workspace, *this->mask);
+        this->reduceColours(maxColours);
+
+        // Leave the workspace ready for the next quantizer
+        Histogram::clear(this->workspace);
+    }
+
+    void WuQuantizer::reduceColours(int maxColours) {
+        // If the image has fewer colours than requested, use these colours
+        if ((int)this->colours.size() <= maxColours) {
+            for (size_t i = 0; i < this->colours.size(); i++) {
+                this->quantizedColours.push_back(Swatch(Histogram::colour(this->colours[i], this->workspace.getWordWidth()), this->histogram[this->colours[i]]));
+            }
+
+        // Otherwise split the colour cube into boxes, using the constants for the word width
+        } else {
+            switch (this->workspace.getWordWidth()) {
+                case 4:
+                    this->quantizeBoxes<4>(maxColours);
+                    break;
+
+                case 5:
+                    this->quantizeBoxes<5>(maxColours);
+                    break;
+
+                case 6:
+                    this->quantizeBoxes<6>(maxColours);
+                    break;
+            }
+        }
+    }
+
+    template <int W>
+    void WuQuantizer::quantizeBoxes(int maxColours) {
+        // Split the whole cube into boxes, always splitting the box with the most variance
+        this->computeMoments<W>();
+        maxColours = std::max(maxColours, 1);
+        std::vector<Box> & boxes = this->workspace.wuBoxes;
+        std::vector<double> & variances = this->workspace.variances;
+        boxes.resize(maxColours);
+        variances.assign(maxColours, 0);
+        const int side = tableSide<W>();
+        boxes[0] = Box{0, side - 1, 0, side - 1, 0, side - 1};
+
+        size_t next = 0;
+        size_t used = 1;
+        while ((int)used < maxColours) {
+            if (this->cut<W>(boxes[next], boxes[used])) {
+                // Boxes with a single cell can't be split any further
+                Box & a = boxes[next];
+                Box & b = boxes[used];
+                variances[next] = ((a.r1 - a.r0) * (a.g1 - a.g0) * (a.b1 - a.b0) > 1 ? this->variance<W>(a) : 0);
+                variances[used] = ((b.r1 - b.r0) * (b.g1 - b.g0) * (b.b1 - b.b0) > 1 ? this->variance<W>(b) : 0);
+                used++;
+            } else {
+                variances[next] = 0;
+            }
+
+            // Find the box to split next, stopping if none can be
+            next = 0;
+            for (size_t i = 1; i < used; i++) {
+                if (variances[i] > variances[next]) {
+                    next = i;
+                }
+            }
+            if (variances[next] <= 0) {
+                break;
+            }
+        }
+
+        // Each box's average colour forms a swatch
+        for (size_t i = 0; i < used; i++) {
+            int64_t weight = volume<W>(boxes[i], this->weights);
+            if (weight == 0) {
+                continue;
+            }
+
+            // Average using the quantized components so the result is itself a quantized colour
+            int r = std::round(volume<W>(boxes[i], this->momentsR)/(double)weight);
+            int g = std::round(volume<W>(boxes[i], this->momentsG)/(double)weight);
+            int b = std::round(volume<W>(boxes[i], this->momentsB)/(double)weight);
+            int c = (((r << W) | g) << W) | b;
+
+            // As the colour is averaged it may not be a colour we want
+            if (this->mask->isAllowed(c)) {
+                this->quantizedColours.push_back(Swatch(Histogram::colour(c, W), weight));
+            }
+        }
+    }
+
+    template <int W>
+    void WuQuantizer::computeMoments() {
+        const size_t side = tableSide<W>();
+        size_t size = side * side * side;
+        this->weights.assign(size, 0);
+        this->momentsR.assign(size, 0);
+        this->momentsG.assign(size, 0);
+        this->momentsB.assign(size, 0);
+        this->moments2.assign(size, 0);
+
+        // Moments of each cell (offset by one so the first row/column/plane stays zero)
+        for (size_t j = 0; j < this->colours.size(); j++) {
+            size_t i = this->colours[j];
+            int64_t pop = this->histogram[i];
+            int r = Histogram::Precision<W>::component(i, 0);
+            int g = Histogram::Precision<W>::component(i, 1);
+            int b = Histogram::Precision<W>::component(i, 2);
+            size_t idx = tableIndex<W>(r + 1, g + 1, b + 1);
+            this->weights[idx] = pop;
+            this->momentsR[idx] = pop * r;
+            this->momentsG[idx] = pop * g;
+            this->momentsB[idx] = pop * b;
+            this->moments2[idx] = pop * (double)((r * r) + (g * g) + (b * b));
+        }
+
+        // Accumulate along each dimension in turn to form the cumulative tables
+        const size_t steps[3] = {1, side, side * side};
+        for (size_t s = 0; s < 3; s++) {
+            for (size_t i = 0; i < size; i++) {
+                // Skip the first cell along this dimension
+                if ((i / steps[s]) % side == 0) {
+                    continue;
+                }
+
+                size_t prev = i - steps[s];
+                this->weights[i] += this->weights[prev];
+                this->momentsR[i] += this->momentsR[prev];
+                this->momentsG[i] += this->momentsG[prev];
+                this->momentsB[i] += this->momentsB[prev];
+                this->moments2[i] += this->moments2[prev];
+            }
+        }
+    }
+
+    template <int W>
+    int64_t WuQuantizer::volume(const Box & box, const std::vector<int64_t> & m) {
+        return boxSum<W, int64_t>(box.r0, box.r1, box.g0, box.g1, box.b0, box.b1, m);
+    }
+
+    template <int W>
+    double WuQuantizer::volume(const Box & box, const std::vector<double> & m) {
+        return boxSum<W, double>(box.r0, box.r1, box.g0, box.g1, box.b0, box.b1, m);
+    }
+
+    template <int W>
+    int64_t WuQuantizer::bottom(const Box & box, Dimension dim, const std::vector<int64_t> & m) {
+        switch (dim) {
+            case Dimension::Red:
+                return -m[tableIndex<W>(box.r0, box.g1, box.b1)] + m[tableIndex<W>(box.r0, box.g1, box.b0)] + m[tableIndex<W>(box.r0, box.g0, box.b1)] - m[tableIndex<W>(box.r0, box.g0, box.b0)];
+
+            case Dimension::Green:
+                return -m[tableIndex<W>(box.r1, box.g0, box.b1)] + m[tableIndex<W>(box.r1, box.g0, box.b0)] + m[tableIndex<W>(box.r0, box.g0, box.b1)] - m[tableIndex<W>(box.r0, box.g0, box.b0)];
+
+            case Dimension::Blue:
+                return -m[tableIndex<W>(box.r1, box.g1, box.b0)] + m[tableIndex<W>(box.r1, box.g0, box.b0)] + m[tableIndex<W>(box.r0, box.g1, box.b0)] - m[tableIndex<W>(box.r0, box.g0, box.b0)];
+        }
+
+        // Never reached
+        return 0;
+    }
+
+    template <int W>
+    int64_t WuQuantizer::top(const Box & box, Dimension dim, int pos, const std::vector<int64_t> & m) {
+        switch (dim) {
+            case Dimension::Red:
+                return m[tableIndex<W>(pos, box.g1, box.b1)] - m[tableIndex<W>(pos, box.g1, box.b0)] - m[tableIndex<W>(pos, box.g0, box.b1)] + m[tableIndex<W>(pos, box.g0, box.b0)];
+
+            case Dimension::Green:
+                return m[tableIndex<W>(box.r1, pos, box.b1)] - m[tableIndex<W>(box.r1, pos, box.b0)] - m[tableIndex<W>(box.r0, pos, box.b1)] + m[tableIndex<W>(box.r0, pos, box.b0)];
+
+            case Dimension::Blue:
+                return m[tableIndex<W>(box.r1, box.g1, pos)] - m[tableIndex<W>(box.r1, box.g0, pos)] - m[tableIndex<W>(box.r0, box.g1, pos)] + m[tableIndex<W>(box.r0, box.g0, pos)];
+        }
+
+        // Never reached
+        return 0;
+    }
+
+    template <int W>
+    double WuQuantizer::variance(const Box & box) const {
+        double weight = volume<W>(box, this->weights);
+        if (weight == 0) {
+            return 0;
+        }
+
+        double r = volume<W>(box, this->momentsR);
+        double g = volume<W>(box, this->momentsG);
+        double b = volume<W>(box, this->momentsB);
+        return volume<W>(box, this->moments2) - (((r * r) + (g * g) + (b * b))/weight);
+    }
+
+    template <int W>
+    double WuQuantizer::maximize(const Box & box, Dimension dim, int first, int last, int & pos, int64_t wholeR, int64_t wholeG, int64_t wholeB, int64_t wholeW) const {
+        int64_t baseR = bottom<W>(box, dim, this->momentsR);
+        int64_t baseG = bottom<W>(box, dim, this->momentsG);
+        int64_t baseB = bottom<W>(box, dim, this->momentsB);
+        int64_t baseW = bottom<W>(box, dim, this->weights);
+
+        double max = 0;
+        pos = -1;
+        for (int i = first; i < last; i++) {
+            // Moments of the lower half when cut at this position
+            double halfR = baseR + top<W>(box, dim, i, this->momentsR);
+            double halfG = baseG + top<W>(box, dim, i, this->momentsG);
+            double halfB = baseB + top<W>(box, dim, i, this->momentsB);
+            double halfW = baseW + top<W>(box, dim, i, this->weights);
+
+            // Neither half can be empty
+            if (halfW == 0 || halfW == wholeW) {
+                continue;
+            }
+
+            double score = ((halfR * halfR) + (halfG * halfG) + (halfB * halfB))/halfW;
+            halfR = wholeR - halfR;
+            halfG = wholeG - halfG;
+            halfB = wholeB - halfB;
+            halfW = wholeW - halfW;
+            score += ((halfR * halfR) + (halfG * halfG) + (halfB * halfB))/halfW;
+
+            if (score > max) {
+                max = score;
+                pos = i;
+            }
+        }
+
+        return max;
+    }
+
+    template <int W>
+    bool WuQuantizer::cut(Box & a, Box & b) const {
+        int64_t wholeR = volume<W>(a, this->momentsR);
+        int64_t wholeG = volume<W>(a, this->momentsG);
+        int64_t wholeB = volume<W>(a, this->momentsB);
+        int64_t wholeW = volume<W>(a, this->weights);
+
+        int cutR, cutG, cutB;
+        double maxR = this->maximize<W>(a, Dimension::Red, a.r0 + 1, a.r1, cutR, wholeR, wholeG, wholeB, wholeW);
+        double maxG = this->maximize<W>(a, Dimension::Green, a.g0 + 1, a.g1, cutG, wholeR, wholeG, wholeB, wholeW);
+        double maxB = this->maximize<W>(a, Dimension::Blue, a.b0 + 1, a.b1, cutB, wholeR, wholeG, wholeB, wholeW);
+
+        // Cut along whichever dimension scores best, which the second box takes the top of
+        b = a;
+        if (maxR >= maxG && maxR >= maxB) {
+            if (cutR < 0) {
+                return false;
+            }
+            a.r1 = b.r0 = cutR;
+
+        } else if (maxG >= maxR && maxG >= maxB) {
+            a.g1 = b.g0 = cutG;
+
+        } else {
+            a.b1 = b.b0 = cutB;
+        }
+
+        return true;
+    }
+
+    std::vector<Swatch> WuQuantizer::getQuantizedColours() {
+        return this->quantizedColours;
+    }
+};
\ No newline at end of file
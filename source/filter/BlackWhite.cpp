@@ -13,4 +13,8 @@ namespace Splash::Filter {
     bool BlackWhite::isAllowed(Colour & col) {
         return !this->isWhiteOrBlack(col);
     }
+
+    std::string BlackWhite::identifier() const {
+        return "BlackWhite";
+    }
 };
\ No newline at end of file
@@ -21,4 +21,8 @@ namespace Splash::Filter {
         HSL hsl = c.hsl();
         return (!this->isWhite(hsl) && !isBlack(hsl) && !isNearRedILine(hsl));
     }
+
+    std::string Default::identifier() const {
+        return "Default";
+    }
 };
\ No newline at end of file
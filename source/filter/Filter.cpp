@@ -1,6 +1,10 @@
 #include "splash/filter/Filter.hpp"
 
 namespace Splash::Filter {
+    std::string Filter::identifier() const {
+        return "";
+    }
+
     Filter::~Filter() {
 
     }
@@ -0,0 +1,77 @@
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Histogram.hpp"
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+
+// Maximum number of masks to keep cached
+#define MAX_CACHED_MASKS 32
+
+namespace Splash::Filter {
+    // Cached masks keyed by the types and identifiers of the chain's filters
+    static std::map< std::string, std::shared_ptr<const FilterMask> > cache;
+    static std::mutex cacheMutex;
+
+    FilterMask::FilterMask(const std::vector<Filter *> & filters, int width) {
+        this->wordWidth = width;
+        this->bits.assign(Histogram::size(width)/64, 0);
+
+        for (size_t i = 0; i < Histogram::size(width); i++) {
+            Colour c = Histogram::colour(i, width);
+
+            bool allowed = true;
+            for (size_t f = 0; f < filters.size() && allowed; f++) {
+                allowed = filters[f]->isAllowed(c);
+            }
+
+            if (allowed) {
+                this->bits[i/64] |= (static_cast<uint64_t>(1) << (i % 64));
+            }
+        }
+    }
+
+    std::shared_ptr<const FilterMask> FilterMask::get(const std::vector<Filter *> & filters, int width) {
+        // Form the key, giving up on caching if any filter can't be identified. The type is included
+        // so that a subclass which inherits its parent's identifier doesn't share its parent's mask
+        std::string key = std::to_string(width) + '\n';
+        for (size_t i = 0; i < filters.size(); i++) {
+            std::string id = filters[i]->identifier();
+            if (id.empty()) {
+                return std::shared_ptr<const FilterMask>(new FilterMask(filters, width));
+            }
+            key += std::string(typeid(*filters[i]).name()) + ' ' + id + '\n';
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        std::map< std::string, std::shared_ptr<const FilterMask> >::iterator it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        // Start again once full, as chains are usually either reused constantly or never again
+        if (cache.size() >= MAX_CACHED_MASKS) {
+            cache.clear();
+        }
+        std::shared_ptr<const FilterMask> mask = std::shared_ptr<const FilterMask>(new FilterMask(filters, width));
+        cache[key] = mask;
+        return mask;
+    }
+
+    void FilterMask::clearCache() {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache.clear();
+    }
+
+    int FilterMask::getWordWidth() const {
+        return this->wordWidth;
+    }
+
+    bool FilterMask::isAllowed(size_t c) const {
+        return (this->bits[c/64] >> (c % 64)) & 1;
+    }
+
+    const uint64_t * FilterMask::data() const {
+        return this->bits.data();
+    }
+};
\ No newline at end of file
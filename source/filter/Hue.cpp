@@ -1,5 +1,6 @@
 #include "splash/filter/Hue.hpp"
 #include <cmath>
+#include <cstdio>
 
 namespace Splash::Filter {
     Hue::Hue(double h) {
@@ -12,4 +13,11 @@ namespace Splash::Filter {
         float diff = std::abs(hsl.h - this->hue);
         return (diff > 10.0f && diff < 350.0f);
     }
+
+    std::string Hue::identifier() const {
+        // Hexadecimal so the hue is represented exactly
+        char buf[48];
+        std::snprintf(buf, sizeof(buf), "Hue %a", this->hue);
+        return std::string(buf);
+    }
 };
\ No newline at end of file
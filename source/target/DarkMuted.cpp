@@ -1,8 +0,0 @@
-#include "splash/target/DarkMuted.hpp"
-
-namespace Splash::Target {
-    DarkMuted::DarkMuted() : Target() {
-        this->setDefaultDarkLightnessValues();
-        this->setDefaultMutedSaturationValues();
-    }
-};
\ No newline at end of file
@@ -1,8 +0,0 @@
-#include "splash/target/DarkVibrant.hpp"
-
-namespace Splash::Target {
-    DarkVibrant::DarkVibrant() : Target() {
-        this->setDefaultDarkLightnessValues();
-        this->setDefaultVibrantSaturationValues();
-    }
-};
\ No newline at end of file
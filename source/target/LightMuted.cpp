@@ -1,8 +0,0 @@
-#include "splash/target/LightMuted.hpp"
-
-namespace Splash::Target {
-    LightMuted::LightMuted() : Target() {
-        this->setDefaultLightLightnessValues();
-        this->setDefaultMutedSaturationValues();
-    }
-};
\ No newline at end of file
@@ -1,8 +0,0 @@
-#include "splash/target/LightVibrant.hpp"
-
-namespace Splash::Target {
-    LightVibrant::LightVibrant() : Target() {
-        this->setDefaultLightLightnessValues();
-        this->setDefaultVibrantSaturationValues();
-    }
-};
\ No newline at end of file
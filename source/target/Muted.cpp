@@ -1,8 +0,0 @@
-#include "splash/target/Muted.hpp"
-
-namespace Splash::Target {
-    Muted::Muted() : Target() {
-        this->setDefaultNormalLightnessValues();
-        this->setDefaultMutedSaturationValues();
-    }
-};
\ No newline at end of file
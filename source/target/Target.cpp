@@ -1,21 +1,7 @@
 #include "splash/target/Target.hpp"
 #include <cstddef>
 
-// Constant values/indexes
-#define TARGET_DARK_LUMA 0.26f
-#define MAX_DARK_LUMA 0.45f
-#define MIN_LIGHT_LUMA 0.55f
-#define TARGET_LIGHT_LUMA 0.74f
-#define MIN_NORMAL_LUMA 0.3f
-#define TARGET_NORMAL_LUMA 0.5f
-#define MAX_NORMAL_LUMA 0.7f
-#define TARGET_MUTED_SATURATION 0.3f
-#define MAX_MUTED_SATURATION 0.4f
-#define TARGET_VIBRANT_SATURATION 1.0f
-#define MIN_VIBRANT_SATURATION 0.35f
-#define WEIGHT_SATURATION 0.24f
-#define WEIGHT_LUMA 0.52f
-#define WEIGHT_POPULATION 0.24f
+// Indexes into each array
 #define INDEX_MIN 0
 #define INDEX_TARGET 1
 #define INDEX_MAX 2
@@ -24,68 +10,8 @@
 #define INDEX_WEIGHT_POP 2
 
 namespace Splash::Target {
-    void Target::setDefaultLightLightnessValues() {
-        this->lightnessTargets[INDEX_MIN] = MIN_LIGHT_LUMA;
-        this->lightnessTargets[INDEX_TARGET] = TARGET_LIGHT_LUMA;
-    }
-
-    void Target::setDefaultNormalLightnessValues() {
-        this->lightnessTargets[INDEX_MIN] = MIN_NORMAL_LUMA;
-        this->lightnessTargets[INDEX_TARGET] = TARGET_NORMAL_LUMA;
-        this->lightnessTargets[INDEX_MAX] = MAX_NORMAL_LUMA;
-    }
-
-    void Target::setDefaultDarkLightnessValues() {
-        this->lightnessTargets[INDEX_TARGET] = TARGET_DARK_LUMA;
-        this->lightnessTargets[INDEX_MAX] = MAX_DARK_LUMA;
-    }
-
-    void Target::setDefaultVibrantSaturationValues() {
-        this->saturationTargets[INDEX_MIN] = MIN_VIBRANT_SATURATION;
-        this->saturationTargets[INDEX_TARGET] = TARGET_VIBRANT_SATURATION;
-    }
-
-    void Target::setDefaultMutedSaturationValues() {
-        this->saturationTargets[INDEX_TARGET] = TARGET_MUTED_SATURATION;
-        this->saturationTargets[INDEX_MAX] = MAX_MUTED_SATURATION;
-    }
-
-    Target::Target() {
-        this->isExclusive_ = true;   // Defaults to true
-        this->lightnessTargets.resize(3, 0);
-        this->saturationTargets.resize(3, 0);
-        this->weights.resize(3, 0);
-
-        // Fill vectors with default values
-        this->setDefaultWeights();
-        this->setTargetDefaultValues(this->lightnessTargets);
-        this->setTargetDefaultValues(this->saturationTargets);
-    }
-
-    Target::Target(const Target & t) {
-        this->isExclusive_ = t.isExclusive_;
-        this->lightnessTargets = t.lightnessTargets;
-        this->saturationTargets = t.saturationTargets;
-        this->weights = t.weights;
-    }
+    Target::Target(const Target * t) : Target(*t) {
 
-    Target::Target(const Target * t) {
-        this->isExclusive_ = t->isExclusive_;
-        this->lightnessTargets = t->lightnessTargets;
-        this->saturationTargets = t->saturationTargets;
-        this->weights = t->weights;
-    }
-
-    void Target::setDefaultWeights() {
-        this->weights[INDEX_WEIGHT_SAT] = WEIGHT_SATURATION;
-        this->weights[INDEX_WEIGHT_LUMA] = WEIGHT_LUMA;
-        this->weights[INDEX_WEIGHT_POP] = WEIGHT_POPULATION;
-    }
-
-    void Target::setTargetDefaultValues(std::vector<float> & arr) {
-        arr[INDEX_MIN] = 0.0f;
-        arr[INDEX_TARGET] = 0.5f;
-        arr[INDEX_MAX] = 1.0f;
     }
 
     float Target::getMinimumSaturation() const {
@@ -145,70 +71,66 @@ namespace Splash::Target {
         }
     }
 
-    Target::Builder::Builder() {
-        this->target = new Target();
+    Target::Builder::Builder() : target() {
+
     }
 
-    Target::Builder::Builder(Target & t) {
-        this->target = new Target(t);
+    Target::Builder::Builder(const Target & t) : target(t) {
+
     }
 
     Target::Builder & Target::Builder::setMinimumSaturation(float v) {
-        this->target->saturationTargets[INDEX_MIN] = v;
+        this->target.saturationTargets[INDEX_MIN] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setTargetSaturation(float v) {
-        this->target->saturationTargets[INDEX_TARGET] = v;
+        this->target.saturationTargets[INDEX_TARGET] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setMaximumSaturation(float v) {
-        this->target->saturationTargets[INDEX_MAX] = v;
+        this->target.saturationTargets[INDEX_MAX] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setSaturationWeight(float v) {
-        this->target->weights[INDEX_WEIGHT_SAT] = v;
+        this->target.weights[INDEX_WEIGHT_SAT] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setMinimumLightness(float v) {
-        this->target->lightnessTargets[INDEX_MIN] = v;
+        this->target.lightnessTargets[INDEX_MIN] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setTargetLightness(float v) {
-        this->target->lightnessTargets[INDEX_TARGET] = v;
+        this->target.lightnessTargets[INDEX_TARGET] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setMaximumLightness(float v) {
-        this->target->lightnessTargets[INDEX_MAX] = v;
+        this->target.lightnessTargets[INDEX_MAX] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setLightnessWeight(float v) {
-        this->target->weights[INDEX_WEIGHT_LUMA] = v;
+        this->target.weights[INDEX_WEIGHT_LUMA] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setPopulationWeight(float v) {
-        this->target->weights[INDEX_WEIGHT_POP] = v;
+        this->target.weights[INDEX_WEIGHT_POP] = v;
         return *this;
     }
 
     Target::Builder & Target::Builder::setExclusive(bool b) {
-        this->target->isExclusive_ = b;
+        this->target.isExclusive_ = b;
         return *this;
     }
 
     Target Target::Builder::build() {
-        return Target(this->target);
-    }
-
-    Target::Builder::~Builder() {
-        delete this->target;
+        return this->target;
     }
 
     bool Target::operator==(const Target t) const {
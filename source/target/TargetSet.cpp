@@ -0,0 +1,88 @@
+#include "splash/Simd.hpp"
+#include "splash/target/DarkMuted.hpp"
+#include "splash/target/DarkVibrant.hpp"
+#include "splash/target/LightMuted.hpp"
+#include "splash/target/LightVibrant.hpp"
+#include "splash/target/Muted.hpp"
+#include "splash/target/TargetSet.hpp"
+#include "splash/target/Vibrant.hpp"
+#include <algorithm>
+
+namespace Splash::Target {
+    // The default targets, in the order of Default
+    static const Target DEFAULTS[NUM_DEFAULTS] = {VIBRANT, LIGHT_VIBRANT, DARK_VIBRANT, MUTED, LIGHT_MUTED, DARK_MUTED};
+
+    TargetSet::TargetSet() {
+        std::fill(this->defaultHandles, this->defaultHandles + NUM_DEFAULTS, -1);
+    }
+
+    TargetSet TargetSet::defaults() {
+        TargetSet set;
+        for (size_t i = 0; i < NUM_DEFAULTS; i++) {
+            set.add(DEFAULTS[i]);
+        }
+        return set;
+    }
+
+    int TargetSet::add(const Target & t) {
+        int handle = this->find(t);
+        if (handle >= 0) {
+            return handle;
+        }
+
+        // Weights which aren't positive are ignored when scoring
+        Target n = t;
+        n.normalizeWeights();
+        const float values[Simd::TARGET_SIZE] = {
+            std::max(n.getSaturationWeight(), 0.0f), std::max(n.getLightnessWeight(), 0.0f), std::max(n.getPopulationWeight(), 0.0f),
+            n.getTargetSaturation(), n.getTargetLightness(),
+            n.getMinimumSaturation(), n.getMaximumSaturation(), n.getMinimumLightness(), n.getMaximumLightness()
+        };
+        this->values.insert(this->values.end(), values, values + Simd::TARGET_SIZE);
+        this->targets.push_back(t);
+        handle = this->targets.size() - 1;
+
+        // Remember where the default targets are
+        for (size_t i = 0; i < NUM_DEFAULTS; i++) {
+            if (t == DEFAULTS[i]) {
+                this->defaultHandles[i] = handle;
+            }
+        }
+        return handle;
+    }
+
+    int TargetSet::find(const Target & t) const {
+        for (size_t i = 0; i < this->targets.size(); i++) {
+            if (this->targets[i] == t) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    int TargetSet::getDefaultHandle(Default d) const {
+        return this->defaultHandles[static_cast<size_t>(d)];
+    }
+
+    void TargetSet::clear() {
+        this->targets.clear();
+        this->values.clear();
+        std::fill(this->defaultHandles, this->defaultHandles + NUM_DEFAULTS, -1);
+    }
+
+    size_t TargetSet::size() const {
+        return this->targets.size();
+    }
+
+    const Target & TargetSet::get(int handle) const {
+        return this->targets[handle];
+    }
+
+    const std::vector<Target> & TargetSet::getTargets() const {
+        return this->targets;
+    }
+
+    const float * TargetSet::getScoringValues() const {
+        return this->values.data();
+    }
+};
\ No newline at end of file
@@ -1,8 +0,0 @@
-#include "splash/target/Vibrant.hpp"
-
-namespace Splash::Target {
-    Vibrant::Vibrant() : Target() {
-        this->setDefaultNormalLightnessValues();
-        this->setDefaultVibrantSaturationValues();
-    }
-};
\ No newline at end of file
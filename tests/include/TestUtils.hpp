@@ -0,0 +1,39 @@
+#ifndef SPLASH_TESTS_TESTUTILS_HPP
+#define SPLASH_TESTS_TESTUTILS_HPP
+
+#include "splash/Bitmap.hpp"
+#include "splash/Swatch.hpp"
+#include <vector>
+
+// Helpers shared by the tests
+
+// Returns a bitmap filled with a repeatable pattern of colours (smooth gradients with some
+// noise so there are plenty of distinct colours), which differs for each seed
+inline Splash::Bitmap createTestBitmap(size_t w, size_t h, unsigned int seed) {
+    Splash::Bitmap b = Splash::Bitmap(w, h);
+    unsigned int state = seed;
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            state = (state * 1103515245) + 12345;
+            int noise = (state >> 16) % 24;
+            Splash::Colour c = Splash::Colour(255, ((x * 255)/w + noise) % 256, ((y * 255)/h + noise) % 256, ((x + y) * 2 + noise) % 256);
+            b.setPixel(c, x, y);
+        }
+    }
+    return b;
+}
+
+// Returns whether both vectors contain the same swatches in the same order
+inline bool sameSwatches(const std::vector<Splash::Swatch> & a, const std::vector<Splash::Swatch> & b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!(a[i] == b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
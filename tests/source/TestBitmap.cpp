@@ -1,5 +1,6 @@
 // This file tests the Bitmap class
 #include "catch.hpp"
+#include "splash/Simd.hpp"
 #include "splash/Splash.hpp"
 
 using namespace Splash;
@@ -91,7 +92,7 @@ TEST_CASE("Bitmap: Resizes correctly", "[bitmap]") {
     REQUIRE(b.getHeight() == 2);
 }
 
-TEST_CASE("Bitmap: Returns a nearest-neighbour scaled bitmap", "[bitmap]") {
+TEST_CASE("Bitmap: Returns a scaled bitmap", "[bitmap]") {
     Colour colours[4] = {Colour(0, 255, 255, 0), Colour(0, 0, 255, 30), Colour(0, 255, 40, 255), Colour(0, 25, 55, 200)};
 
     // We'll use a simple 4 colour bitmap here
@@ -134,4 +135,111 @@ TEST_CASE("Bitmap: Returns a nearest-neighbour scaled bitmap", "[bitmap]") {
         }
         REQUIRE(good);
     }
+}
+
+TEST_CASE("Bitmap: Rows are padded to the stride", "[bitmap]") {
+    Bitmap b = Bitmap(17, 3);
+    REQUIRE(b.getStride() >= b.getWidth());
+
+    Colour c = Colour(255, 1, 2, 3);
+    b.setPixel(c, 4, 2);
+    REQUIRE(b.data()[(2 * b.getStride()) + 4].raw() == c.raw());
+}
+
+TEST_CASE("Bitmap: Can import/export rows", "[bitmap]") {
+    const size_t stride = 7;
+    std::vector<Colour> src(stride * 4);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = Colour(255, i, i * 2, i * 3);
+    }
+
+    Bitmap b = Bitmap(5, 4);
+    SECTION("All rows") {
+        REQUIRE(b.importRows(src.data(), stride, 0, 4) == 4);
+        REQUIRE(b.getPixel(3, 2).raw() == src[(2 * stride) + 3].raw());
+
+        std::vector<Colour> dst(5 * 4);
+        REQUIRE(b.exportRows(dst.data(), 5, 0, 4) == 4);
+        bool good = true;
+        for (size_t y = 0; y < 4; y++) {
+            for (size_t x = 0; x < 5; x++) {
+                good &= (dst[(y * 5) + x].raw() == src[(y * stride) + x].raw());
+            }
+        }
+        REQUIRE(good);
+    }
+
+    SECTION("Rows past the bottom are ignored") {
+        REQUIRE(b.importRows(src.data(), stride, 3, 4) == 1);
+        REQUIRE(b.getPixel(0, 3).raw() == src[0].raw());
+        REQUIRE(b.getPixel(0, 2).raw() == (0xffffffff));
+    }
+}
+
+TEST_CASE("Bitmap: Resizing keeps existing pixels", "[bitmap]") {
+    Bitmap b = Bitmap(4, 4);
+    Colour c = Colour(255, 10, 20, 30);
+    b.setPixel(c, 3, 3);
+
+    b.setWidth(40);
+    b.setHeight(6);
+    REQUIRE(b.getPixel(3, 3).raw() == c.raw());
+    REQUIRE(b.getPixel(39, 5).raw() == (0xffffffff));
+}
+
+TEST_CASE("Bitmap: Scaling down averages the covered pixels", "[bitmap]") {
+    // Alternating black and white columns
+    Bitmap b = Bitmap(4, 2);
+    Colour black = Colour(255, 0, 0, 0);
+    for (size_t y = 0; y < 2; y++) {
+        b.setPixel(black, 0, y);
+        b.setPixel(black, 2, y);
+    }
+
+    SECTION("In sRGB") {
+        Bitmap b2 = b.createScaledBitmap(2, 1);
+        REQUIRE(b2.getPixel(0, 0).raw() == (0xff808080));
+        REQUIRE(b2.getPixel(1, 0).raw() == (0xff808080));
+    }
+
+    SECTION("In linear light") {
+        Bitmap b2 = b.createScaledBitmap(1, 1, true);
+        Colour c = b2.getPixel(0, 0);
+        REQUIRE(c.a() == 255);
+        REQUIRE((c.r() >= 187 && c.r() <= 189));
+        REQUIRE(c.r() == c.g());
+        REQUIRE(c.g() == c.b());
+    }
+}
+
+TEST_CASE("Bitmap: Scaling gives the same result with every instruction set", "[bitmap]") {
+    Bitmap b = Bitmap(257, 131);
+    for (size_t y = 0; y < b.getHeight(); y++) {
+        for (size_t x = 0; x < b.getWidth(); x++) {
+            Colour c = Colour((x * 7) % 256, (x * y) % 256, (y * 3) % 256, (x + y) % 256);
+            b.setPixel(c, x, y);
+        }
+    }
+
+    Simd::ISA original = Simd::getISA();
+    Simd::setISA(Simd::ISA::Scalar);
+    Bitmap expected = b.createScaledBitmap(37, 29);
+
+    Simd::ISA isas[3] = {Simd::ISA::SSE2, Simd::ISA::AVX2, Simd::ISA::NEON};
+    for (size_t i = 0; i < 3; i++) {
+        if (!Simd::setISA(isas[i])) {
+            continue;
+        }
+
+        Bitmap scaled = b.createScaledBitmap(37, 29);
+        bool good = true;
+        for (size_t y = 0; y < 29; y++) {
+            for (size_t x = 0; x < 37; x++) {
+                good &= (scaled.getPixel(x, y).raw() == expected.getPixel(x, y).raw());
+            }
+        }
+        INFO(Simd::toString(isas[i]));
+        REQUIRE(good);
+    }
+    Simd::setISA(original);
 }
\ No newline at end of file
@@ -0,0 +1,142 @@
+// This file tests the BitmapView class
+#include "catch.hpp"
+#include "splash/Splash.hpp"
+
+using namespace Splash;
+
+TEST_CASE("BitmapView: A default view should always be invalid", "[bitmapview]") {
+    BitmapView v = BitmapView();
+    REQUIRE(!v.isValid());
+    REQUIRE(v.getWidth() == 0);
+    REQUIRE(v.getHeight() == 0);
+}
+
+TEST_CASE("BitmapView: Reads a caller-provided buffer in place", "[bitmapview]") {
+    // 3x2 image stored with a stride of 4 pixels
+    std::vector<Colour> buffer(4 * 2);
+    for (size_t i = 0; i < buffer.size(); i++) {
+        buffer[i] = Colour(255, i, 0, 0);
+    }
+    BitmapView v = BitmapView(buffer.data(), 3, 2, 4);
+
+    REQUIRE(v.isValid());
+    REQUIRE(v.getPixel(2, 1).raw() == buffer[6].raw());
+    REQUIRE(v.getRow(1) == &buffer[4]);
+    REQUIRE(v.getStride() == 4 * sizeof(Colour));
+    REQUIRE(v.getPixel(3, 0).raw() == (0xffffffff));
+
+    // Changes to the buffer are visible through the view
+    buffer[0] = Colour(255, 1, 2, 3);
+    REQUIRE(v.getPixel(0, 0).raw() == buffer[0].raw());
+}
+
+TEST_CASE("BitmapView: Views a Bitmap without copying", "[bitmapview]") {
+    Bitmap b = Bitmap(10, 10);
+    BitmapView v = b;
+
+    REQUIRE(v.getWidth() == 10);
+    REQUIRE(v.getHeight() == 10);
+    REQUIRE(v.getRow(0) == b.data());
+    REQUIRE(v.getRow(3) == b.data() + (3 * b.getStride()));
+}
+
+TEST_CASE("BitmapView: Crops without copying", "[bitmapview]") {
+    Bitmap b = Bitmap(10, 10);
+    Colour c = Colour(255, 20, 40, 60);
+    b.setPixel(c, 5, 6);
+    BitmapView v = BitmapView(b);
+
+    SECTION("Cropped region is relative to the view") {
+        BitmapView crop = v.crop(4, 4, 3, 3);
+        REQUIRE(crop.getWidth() == 3);
+        REQUIRE(crop.getHeight() == 3);
+        REQUIRE(crop.getPixel(1, 2).raw() == c.raw());
+        REQUIRE(crop.getRow(0) == b.data() + (4 * b.getStride()) + 4);
+    }
+
+    SECTION("Crops are clipped to the view") {
+        BitmapView crop = v.crop(8, 9, 10, 10);
+        REQUIRE(crop.getWidth() == 2);
+        REQUIRE(crop.getHeight() == 1);
+
+        crop = v.crop(20, 20, 5, 5);
+        REQUIRE(crop.getWidth() == 0);
+        REQUIRE(crop.getHeight() == 0);
+    }
+}
+
+TEST_CASE("BitmapView: Palettes from a view match palettes from a Bitmap", "[bitmapview]") {
+    Bitmap b = Bitmap(64, 64);
+    for (size_t y = 0; y < 64; y++) {
+        for (size_t x = 0; x < 64; x++) {
+            Colour c = Colour(255, x * 4, y * 4, (x * y) % 256);
+            b.setPixel(c, x, y);
+        }
+    }
+    std::vector<Colour> buffer = b.getPixels(0, 0, 64, 64);
+
+    std::vector<Swatch> fromBitmap = Palette::from(b).generate().getSwatches();
+    std::vector<Swatch> fromView = Palette::from(BitmapView(buffer.data(), 64, 64, 64)).generate().getSwatches();
+    REQUIRE(fromBitmap.size() == fromView.size());
+    for (size_t i = 0; i < fromBitmap.size(); i++) {
+        REQUIRE(fromBitmap[i] == fromView[i]);
+    }
+}
+
+TEST_CASE("BitmapView: Reads each supported pixel format", "[bitmapview]") {
+    // Pixel (a=255, r=0x12, g=0x34, b=0x56) stored in each format
+    unsigned int argb = 0xff123456;
+    unsigned char rgba[4] = {0x12, 0x34, 0x56, 0xff};
+    unsigned char bgra[4] = {0x56, 0x34, 0x12, 0xff};
+    unsigned char rgb[3] = {0x12, 0x34, 0x56};
+    uint16_t rgb565 = (0x12 >> 3) << 11 | (0x34 >> 2) << 5 | (0x56 >> 3);
+
+    REQUIRE(BitmapView(&argb, 1, 1, 4, PixelFormat::ARGB8888).getPixel(0, 0).raw() == argb);
+    REQUIRE(BitmapView(rgba, 1, 1, 4, PixelFormat::RGBA8888).getPixel(0, 0).raw() == argb);
+    REQUIRE(BitmapView(bgra, 1, 1, 4, PixelFormat::BGRA8888).getPixel(0, 0).raw() == argb);
+    REQUIRE(BitmapView(rgb, 1, 1, 3, PixelFormat::RGB888).getPixel(0, 0).raw() == argb);
+
+    // RGB565 loses precision, but is expanded by replicating the top bits
+    Colour c = BitmapView(&rgb565, 1, 1, 2, PixelFormat::RGB565).getPixel(0, 0);
+    REQUIRE(c.a() == 0xff);
+    REQUIRE(c.r() == ((0x12 & 0xf8) | (0x12 >> 5)));
+    REQUIRE(c.g() == ((0x34 & 0xfc) | (0x34 >> 6)));
+    REQUIRE(c.b() == ((0x56 & 0xf8) | (0x56 >> 5)));
+}
+
+TEST_CASE("BitmapView: Palettes are the same for each pixel format", "[bitmapview]") {
+    const size_t w = 48;
+    const size_t h = 40;
+
+    // Build the same image in each 8-bit format (rows padded with an extra pixel)
+    std::vector<unsigned int> argb((w + 1) * h);
+    std::vector<unsigned char> rgba((w + 1) * h * 4);
+    std::vector<unsigned char> bgra((w + 1) * h * 4);
+    std::vector<unsigned char> rgb((w + 1) * h * 3);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            unsigned char r = x * 5;
+            unsigned char g = y * 6;
+            unsigned char b = (x * y) % 256;
+            size_t i = (y * (w + 1)) + x;
+            argb[i] = 0xff000000 | (r << 16) | (g << 8) | b;
+            rgba[(i * 4)] = r; rgba[(i * 4) + 1] = g; rgba[(i * 4) + 2] = b; rgba[(i * 4) + 3] = 0xff;
+            bgra[(i * 4)] = b; bgra[(i * 4) + 1] = g; bgra[(i * 4) + 2] = r; bgra[(i * 4) + 3] = 0xff;
+            rgb[(i * 3)] = r; rgb[(i * 3) + 1] = g; rgb[(i * 3) + 2] = b;
+        }
+    }
+
+    std::vector<Swatch> expected = Palette::from(BitmapView(argb.data(), w, h, (w + 1) * 4, PixelFormat::ARGB8888)).generate().getSwatches();
+    std::vector<BitmapView> views = {
+        BitmapView(rgba.data(), w, h, (w + 1) * 4, PixelFormat::RGBA8888),
+        BitmapView(bgra.data(), w, h, (w + 1) * 4, PixelFormat::BGRA8888),
+        BitmapView(rgb.data(), w, h, (w + 1) * 3, PixelFormat::RGB888)
+    };
+    for (size_t i = 0; i < views.size(); i++) {
+        std::vector<Swatch> swatches = Palette::from(views[i]).generate().getSwatches();
+        REQUIRE(swatches.size() == expected.size());
+        for (size_t j = 0; j < swatches.size(); j++) {
+            REQUIRE(swatches[j] == expected[j]);
+        }
+    }
+}
\ No newline at end of file
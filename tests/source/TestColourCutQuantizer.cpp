@@ -0,0 +1,284 @@
+// This file tests the ColourCutQuantizer class
+#include "catch.hpp"
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/filter/Default.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/Palette.hpp"
+#include "splash/Simd.hpp"
+#include "TestUtils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+using namespace Splash;
+
+// Reference copy of the median cut as it was originally ported, which sorts each box's
+// colours to find where to split it. Used to check that optimizations don't change the result.
+namespace Reference {
+    struct Box {
+        size_t lower;
+        size_t upper;
+        int64_t population;
+        int minR, minG, minB;
+        int maxR, maxG, maxB;
+    };
+
+    static int component(int c, int shift) {
+        return (c >> shift) & 0x1F;
+    }
+
+    static void fit(Box & box, const std::vector<int> & colours, const std::vector<int64_t> & histogram) {
+        box.minR = box.minG = box.minB = 32;
+        box.maxR = box.maxG = box.maxB = -1;
+        box.population = 0;
+        for (size_t i = box.lower; i <= box.upper; i++) {
+            int c = colours[i];
+            box.population += histogram[c];
+            box.minR = std::min(box.minR, component(c, 10));
+            box.maxR = std::max(box.maxR, component(c, 10));
+            box.minG = std::min(box.minG, component(c, 5));
+            box.maxG = std::max(box.maxG, component(c, 5));
+            box.minB = std::min(box.minB, component(c, 0));
+            box.maxB = std::max(box.maxB, component(c, 0));
+        }
+    }
+
+    static bool compare(Box & a, Box & b) {
+        int va = (a.maxR - a.minR + 1) * (a.maxG - a.minG + 1) * (a.maxB - a.minB + 1);
+        int vb = (b.maxR - b.minR + 1) * (b.maxG - b.minG + 1) * (b.maxB - b.minB + 1);
+        return va < vb;
+    }
+
+    // Swaps the given component (0 = red, 1 = green, 2 = blue) with red
+    static void swapSignificant(std::vector<int> & colours, int dim, size_t lower, size_t upper) {
+        for (size_t i = lower; i <= upper && dim != 0; i++) {
+            int c = colours[i];
+            int r = component(c, 10), g = component(c, 5), b = component(c, 0);
+            colours[i] = (dim == 1 ? ((g << 10) | (r << 5) | b) : ((b << 10) | (g << 5) | r));
+        }
+    }
+
+    static std::vector<Swatch> quantize(std::vector<int64_t> histogram, int maxColours, const Filter::FilterMask & mask) {
+        std::vector<int> colours;
+        for (size_t i = 0; i < histogram.size(); i++) {
+            if (histogram[i] > 0 && mask.isAllowed(i)) {
+                colours.push_back(i);
+            }
+        }
+
+        std::vector<Swatch> swatches;
+        if ((int)colours.size() <= maxColours) {
+            for (size_t i = 0; i < colours.size(); i++) {
+                swatches.push_back(Swatch(Histogram::colour(colours[i]), histogram[colours[i]]));
+            }
+            return swatches;
+        }
+
+        std::priority_queue<Box, std::vector<Box>, decltype(&compare)> queue(compare);
+        Box first = {0, colours.size() - 1};
+        fit(first, colours, histogram);
+        queue.push(first);
+        while ((int)queue.size() < maxColours) {
+            Box box = queue.top();
+            queue.pop();
+            if (box.upper == box.lower) {
+                break;
+            }
+
+            // Sort along the longest dimension
+            int lr = box.maxR - box.minR, lg = box.maxG - box.minG, lb = box.maxB - box.minB;
+            int dim = (lr >= lg && lr >= lb ? 0 : (lg >= lr && lg >= lb ? 1 : 2));
+            swapSignificant(colours, dim, box.lower, box.upper);
+            std::stable_sort(colours.begin() + box.lower, colours.begin() + box.upper + 1);
+            swapSignificant(colours, dim, box.lower, box.upper);
+
+            // Split where the population reaches the midpoint
+            size_t split = box.lower;
+            int64_t count = 0;
+            for (size_t i = box.lower; i <= box.upper; i++) {
+                count += histogram[colours[i]];
+                if (count >= box.population/2) {
+                    split = std::min(box.upper - 1, i);
+                    break;
+                }
+            }
+
+            Box upper = {split + 1, box.upper};
+            fit(upper, colours, histogram);
+            box.upper = split;
+            fit(box, colours, histogram);
+            queue.push(upper);
+            queue.push(box);
+        }
+
+        while (!queue.empty()) {
+            Box box = queue.top();
+            queue.pop();
+
+            int r = 0, g = 0, b = 0;
+            for (size_t i = box.lower; i <= box.upper; i++) {
+                int pop = histogram[colours[i]];
+                r += pop * component(colours[i], 10);
+                g += pop * component(colours[i], 5);
+                b += pop * component(colours[i], 0);
+            }
+            int c = ((int)std::round(r/(float)box.population) << 10) | ((int)std::round(g/(float)box.population) << 5) | (int)std::round(b/(float)box.population);
+            if (mask.isAllowed(c)) {
+                swatches.push_back(Swatch(Histogram::colour(c), box.population));
+            }
+        }
+        return swatches;
+    }
+};
+
+TEST_CASE("ColourCutQuantizer: Matches the original sorting implementation", "[quantizer]") {
+    Filter::Default def = Filter::Default();
+    std::vector<Filter::Filter *> none;
+    std::vector<Filter::Filter *> filters = {&def};
+
+    for (unsigned int seed = 1; seed <= 6; seed++) {
+        Bitmap b = createTestBitmap(40 + seed * 37, 30 + seed * 23, seed);
+        std::vector<int64_t> histogram = Histogram::count(b, 1);
+
+        int counts[4] = {1, 8, 16, 64};
+        for (size_t i = 0; i < 4; i++) {
+            INFO("Seed " << seed << ", " << counts[i] << " colours");
+            ColourCutQuantizer q = ColourCutQuantizer(b, counts[i], none);
+            REQUIRE(sameSwatches(q.getQuantizedColours(), Reference::quantize(histogram, counts[i], *Filter::FilterMask::get(none))));
+
+            ColourCutQuantizer f = ColourCutQuantizer(b, counts[i], filters);
+            REQUIRE(sameSwatches(f.getQuantizedColours(), Reference::quantize(histogram, counts[i], *Filter::FilterMask::get(filters))));
+        }
+    }
+}
+
+TEST_CASE("ColourCutQuantizer: Scaling while counting matches quantizing a scaled bitmap", "[quantizer]") {
+    Bitmap b = createTestBitmap(300, 217, 1);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+
+    Bitmap scaled = b.createScaledBitmap(97, 71);
+    ColourCutQuantizer expected = ColourCutQuantizer(scaled, 16, filters);
+    ColourCutQuantizer fused = ColourCutQuantizer(b, 97, 71, 16, filters);
+    REQUIRE(sameSwatches(expected.getQuantizedColours(), fused.getQuantizedColours()));
+
+    delete filters[0];
+}
+
+TEST_CASE("ColourCutQuantizer: Counting on multiple threads gives identical results", "[quantizer]") {
+    Bitmap b = createTestBitmap(640, 480, 2);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+
+    SECTION("Unscaled") {
+        ColourCutQuantizer serial = ColourCutQuantizer(b, 24, filters, 1);
+        ColourCutQuantizer parallel = ColourCutQuantizer(b, 24, filters, 4);
+        REQUIRE(sameSwatches(serial.getQuantizedColours(), parallel.getQuantizedColours()));
+    }
+
+    SECTION("Scaled") {
+        ColourCutQuantizer serial = ColourCutQuantizer(b, 500, 400, 24, filters, 1);
+        ColourCutQuantizer parallel = ColourCutQuantizer(b, 500, 400, 24, filters, 3);
+        REQUIRE(sameSwatches(serial.getQuantizedColours(), parallel.getQuantizedColours()));
+    }
+
+    delete filters[0];
+}
+
+TEST_CASE("ColourCutQuantizer: Splitting boxes on multiple threads gives identical results", "[quantizer]") {
+    Bitmap b = createTestBitmap(640, 480, 4);
+    std::vector<Filter::Filter *> filters;
+
+    const int counts[3] = {64, 128, 256};
+    for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+        for (size_t i = 0; i < 3; i++) {
+            INFO("Width: " << width << ", colours: " << counts[i]);
+            ColourCutQuantizer serial = ColourCutQuantizer(b, counts[i], filters, 1, nullptr, width);
+            ColourCutQuantizer parallel = ColourCutQuantizer(b, counts[i], filters, 4, nullptr, width);
+            REQUIRE(sameSwatches(serial.getQuantizedColours(), parallel.getQuantizedColours()));
+        }
+    }
+}
+
+TEST_CASE("ColourCutQuantizer: Each instruction set gives identical results", "[quantizer]") {
+    // Odd width so the scalar tail of each kernel is used too
+    Bitmap b = createTestBitmap(203, 151, 3);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+
+    Simd::ISA original = Simd::getISA();
+    Simd::setISA(Simd::ISA::Scalar);
+    ColourCutQuantizer expected = ColourCutQuantizer(b, 16, filters);
+
+    Simd::ISA isas[3] = {Simd::ISA::SSE2, Simd::ISA::AVX2, Simd::ISA::NEON};
+    for (size_t i = 0; i < 3; i++) {
+        if (!Simd::setISA(isas[i])) {
+            continue;
+        }
+
+        ColourCutQuantizer quantizer = ColourCutQuantizer(b, 16, filters);
+        INFO(Simd::toString(isas[i]));
+        REQUIRE(sameSwatches(expected.getQuantizedColours(), quantizer.getQuantizedColours()));
+    }
+    Simd::setISA(original);
+
+    delete filters[0];
+}
+
+TEST_CASE("ColourCutQuantizer: Populations don't overflow at full resolution", "[quantizer]") {
+    // A single row repeated (with a stride of zero) gives a huge image without the memory.
+    // Averaging its colours sums more than 2^31 for each component.
+    const size_t width = 8192;
+    const size_t height = 9000;
+    std::vector<Colour> row(width, Colour(255, 200, 40, 40));
+    std::fill(row.begin(), row.begin() + width/2, Colour(255, 192, 40, 40));
+    BitmapView view = BitmapView(row.data(), width, height, 0);
+    std::vector<Filter::Filter *> filters;
+
+    SECTION("Quantizer") {
+        ColourCutQuantizer quantizer = ColourCutQuantizer(view, 1, filters, 4);
+        std::vector<Swatch> swatches = quantizer.getQuantizedColours();
+        REQUIRE(swatches.size() == 1);
+        REQUIRE(swatches[0].getPopulation() == static_cast<int64_t>(width * height));
+        REQUIRE(swatches[0].getColour().r() >= 192);
+        REQUIRE(swatches[0].getColour().r() <= 207);
+        REQUIRE(swatches[0].getColour().g() == 40);
+    }
+
+    SECTION("Palette") {
+        Palette palette = Palette::from(view).resizeBitmapArea(0).setThreadCount(0).setMaximumColourCount(1).generate();
+        Swatch dominant = palette.getDominantSwatch();
+        REQUIRE(dominant.getPopulation() == static_cast<int64_t>(width * height));
+    }
+}
+
+TEST_CASE("ColourCutQuantizer: Colours can be quantized with each word width", "[quantizer]") {
+    Bitmap b = createTestBitmap(320, 240, 5);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+
+    // The default is 5 bits
+    ColourCutQuantizer def = ColourCutQuantizer(b, 16, filters);
+    ColourCutQuantizer five = ColourCutQuantizer(b, 16, filters, 1, nullptr, 5);
+    REQUIRE(sameSwatches(def.getQuantizedColours(), five.getQuantizedColours()));
+
+    for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+        INFO("Width: " << width);
+        ColourCutQuantizer quantizer = ColourCutQuantizer(b, 16, filters, 1, nullptr, width);
+        std::vector<Swatch> swatches = quantizer.getQuantizedColours();
+        REQUIRE(!swatches.empty());
+        REQUIRE(swatches.size() <= 16);
+        for (size_t i = 0; i < swatches.size(); i++) {
+            Colour c = swatches[i].getColour();
+            REQUIRE(filters[0]->isAllowed(c));
+        }
+
+        // Colours are used as is when there are few of them
+        Colour orange = Colour(255, 0xff, 0x80, 0x10);
+        Colour blue = Colour(255, 0x10, 0x80, 0xff);
+        Bitmap small = Bitmap(2, 1);
+        small.setPixel(orange, 0, 0);
+        small.setPixel(blue, 1, 0);
+        ColourCutQuantizer few = ColourCutQuantizer(small, 16, filters, 1, nullptr, width);
+        REQUIRE(few.getQuantizedColours().size() == 2);
+        REQUIRE(few.getQuantizedColours()[0].getColour().r() == (0x10 >> (8 - width)) << (8 - width));
+    }
+
+    delete filters[0];
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+// This file tests the ColourHistogram class
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/ColourHistogram.hpp"
+#include "splash/Palette.hpp"
+#include "TestUtils.hpp"
+#include <algorithm>
+#include <type_traits>
+
+using namespace Splash;
+
+TEST_CASE("ColourHistogram: Counts match the histogram", "[histogram]") {
+    Bitmap b = createTestBitmap(120, 90, 1);
+    std::vector<int64_t> expected = Histogram::count(b, 1);
+
+    ColourHistogram h = ColourHistogram(b);
+    REQUIRE(h.getWordWidth() == Histogram::WORD_WIDTH);
+    REQUIRE(h.getPopulation() == 120 * 90);
+
+    size_t occupied = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (expected[i] > 0) {
+            occupied++;
+            REQUIRE(h.getCount(Histogram::colour(i)) == expected[i]);
+        }
+    }
+    REQUIRE(h.size() == occupied);
+
+    // The number of threads doesn't change the counts
+    REQUIRE(ColourHistogram(b, 4) == h);
+    REQUIRE(ColourHistogram().empty());
+
+    // Numbers and pixels aren't turned into histograms by accident
+    static_assert(!std::is_convertible<int, ColourHistogram>::value, "ColourHistogram should not be constructed implicitly");
+    static_assert(!std::is_convertible<Bitmap, ColourHistogram>::value, "ColourHistogram should not be constructed implicitly");
+}
+
+TEST_CASE("ColourHistogram: Merging and subtracting", "[histogram]") {
+    Bitmap b = createTestBitmap(120, 90, 2);
+    ColourHistogram whole = ColourHistogram(b);
+    ColourHistogram top = ColourHistogram(BitmapView(b).crop(0, 0, 120, 40));
+    ColourHistogram bottom = ColourHistogram(BitmapView(b).crop(0, 40, 120, 50));
+
+    SECTION("Merging both halves gives the whole") {
+        ColourHistogram h = top;
+        REQUIRE(h.merge(bottom));
+        REQUIRE(h == whole);
+    }
+
+    SECTION("Subtracting a half gives the other half") {
+        ColourHistogram h = whole;
+        REQUIRE(h.subtract(top));
+        REQUIRE(h == bottom);
+        REQUIRE(h.subtract(bottom));
+        REQUIRE(h.empty());
+        REQUIRE(h.size() == 0);
+    }
+
+    SECTION("Counts don't go below zero") {
+        ColourHistogram h = top;
+        REQUIRE(h.subtract(whole));
+        REQUIRE(h.empty());
+        REQUIRE(h.getCount(b.getPixel(0, 0)) == 0);
+    }
+
+    SECTION("Histograms with different word widths aren't combined") {
+        ColourHistogram h = top;
+        ColourHistogram other = ColourHistogram(b, 1, 6);
+        REQUIRE_FALSE(h.merge(other));
+        REQUIRE_FALSE(h.subtract(other));
+        REQUIRE(h == top);
+    }
+}
+
+TEST_CASE("ColourHistogram: Serializing", "[histogram]") {
+    Bitmap b = createTestBitmap(120, 90, 3);
+
+    SECTION("Round trip at each word width") {
+        for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+            ColourHistogram h = ColourHistogram(b, 1, width);
+            ColourHistogram loaded;
+            REQUIRE(loaded.deserialize(h.serialize()));
+            REQUIRE(loaded == h);
+            REQUIRE(loaded.getWordWidth() == width);
+        }
+
+        ColourHistogram loaded = ColourHistogram(b);
+        REQUIRE(loaded.deserialize(ColourHistogram(6).serialize()));
+        REQUIRE(loaded.empty());
+        REQUIRE(loaded.getWordWidth() == 6);
+    }
+
+    SECTION("Invalid blobs are rejected") {
+        std::vector<uint8_t> blob = ColourHistogram(b).serialize();
+        std::vector< std::vector<uint8_t> > invalid;
+        invalid.push_back(std::vector<uint8_t>());
+
+        // Bad magic
+        invalid.push_back(blob);
+        invalid.back()[0] = 'X';
+
+        // Unsupported word width
+        invalid.push_back(blob);
+        invalid.back()[5] = Histogram::MAX_WORD_WIDTH + 1;
+
+        // Truncated
+        invalid.push_back(std::vector<uint8_t>(blob.begin(), blob.end() - 1));
+
+        // Trailing bytes
+        invalid.push_back(blob);
+        invalid.back().push_back(0);
+
+        // Bin outside of the histogram
+        std::vector<uint8_t> outside = {'S', 'P', 'L', 'H', 1, 4, 1, 0x80, 0x20, 1};
+        invalid.push_back(outside);
+
+        for (size_t i = 0; i < invalid.size(); i++) {
+            INFO("Blob: " << i);
+            ColourHistogram h = ColourHistogram(b);
+            REQUIRE_FALSE(h.deserialize(invalid[i]));
+            REQUIRE(h.empty());
+        }
+    }
+}
+
+TEST_CASE("ColourHistogram: Generating a palette", "[histogram]") {
+    Bitmap b = createTestBitmap(120, 90, 4);
+    ColourHistogram h = ColourHistogram(b);
+
+    std::vector<Swatch> expected = Palette::from(b).resizeBitmapArea(0).generate().getSwatches();
+    REQUIRE(Palette::from(h).generate().getSwatches() == expected);
+
+    // The histogram is copied, so later changes don't affect the builder
+    Palette::Builder builder = Palette::from(h);
+    h.merge(ColourHistogram(createTestBitmap(64, 64, 5)));
+    REQUIRE(builder.generate().getSwatches() == expected);
+
+    // Merged art gives the same palette as counting all of the pixels together
+    Bitmap c = createTestBitmap(120, 90, 6);
+    Bitmap both = Bitmap(120, 180);
+    for (size_t y = 0; y < 90; y++) {
+        for (size_t x = 0; x < 120; x++) {
+            Colour top = b.getPixel(x, y);
+            Colour bottom = c.getPixel(x, y);
+            both.setPixel(top, x, y);
+            both.setPixel(bottom, x, y + 90);
+        }
+    }
+    ColourHistogram album = ColourHistogram(b);
+    album.merge(ColourHistogram(c));
+    REQUIRE(Palette::from(album).generate().getSwatches() == Palette::from(both).resizeBitmapArea(0).generate().getSwatches());
+}
+
+TEST_CASE("ColourHistogram: Counts larger than an int keep their exact populations", "[histogram]") {
+    // Two reds for every blue, doubled until the counts don't fit in an int
+    Bitmap b = Bitmap(3, 1);
+    Colour red = Colour(255, 200, 40, 40);
+    Colour blue = Colour(255, 40, 40, 200);
+    b.setPixel(red, 0, 0);
+    b.setPixel(red, 1, 0);
+    b.setPixel(blue, 2, 0);
+    ColourHistogram h = ColourHistogram(b);
+    for (size_t i = 0; i < 31; i++) {
+        REQUIRE(h.merge(h));
+    }
+    REQUIRE(h.getCount(red) == (static_cast<int64_t>(1) << 32));
+    REQUIRE(h.getCount(blue) == (static_cast<int64_t>(1) << 31));
+
+    std::vector<Swatch> swatches = Palette::from(h).clearFilters().generate().getSwatches();
+    REQUIRE(swatches.size() == 2);
+    REQUIRE(std::max(swatches[0].getPopulation(), swatches[1].getPopulation()) == (static_cast<int64_t>(1) << 32));
+    REQUIRE(std::min(swatches[0].getPopulation(), swatches[1].getPopulation()) == (static_cast<int64_t>(1) << 31));
+}
\ No newline at end of file
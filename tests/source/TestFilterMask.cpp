@@ -0,0 +1,105 @@
+// This file tests the FilterMask class
+#include "catch.hpp"
+#include "splash/filter/BlackWhite.hpp"
+#include "splash/filter/Default.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/filter/Hue.hpp"
+
+using namespace Splash;
+
+// Filter without an identifier which only allows colours with more red than blue
+class RedderThanBlue : public Filter::Filter {
+    public:
+        bool isAllowed(Colour & c) {
+            return c.r() > c.b();
+        }
+};
+
+// Subclass of the default filter which also rejects colours with more blue than red,
+// inheriting the default filter's identifier
+class DefaultNotBlue : public Filter::Default {
+    public:
+        bool isAllowed(Colour & c) {
+            return Default::isAllowed(c) && c.r() >= c.b();
+        }
+};
+
+// Returns whether the mask matches running the filters on each colour (with the given bits per component)
+static bool matchesFilters(const Filter::FilterMask & mask, std::vector<Filter::Filter *> & filters, int width = 5) {
+    const int m = (1 << width) - 1;
+    for (size_t i = 0; i < (static_cast<size_t>(1) << (width * 3)); i++) {
+        Colour c = Colour(255, ((i >> (width * 2)) & m) << (8 - width), ((i >> width) & m) << (8 - width), (i & m) << (8 - width));
+        bool allowed = true;
+        for (size_t f = 0; f < filters.size(); f++) {
+            allowed &= filters[f]->isAllowed(c);
+        }
+
+        if (mask.isAllowed(i) != allowed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("FilterMask: Mask matches evaluating the filters", "[filter]") {
+    Filter::Default def = Filter::Default();
+    Filter::BlackWhite bw = Filter::BlackWhite();
+    Filter::Hue hue = Filter::Hue(200.0);
+    RedderThanBlue red = RedderThanBlue();
+
+    std::vector<Filter::Filter *> none;
+    REQUIRE(matchesFilters(*Filter::FilterMask::get(none), none));
+
+    std::vector<Filter::Filter *> filters = {&def, &bw, &hue, &red};
+    REQUIRE(matchesFilters(*Filter::FilterMask::get(filters), filters));
+}
+
+TEST_CASE("FilterMask: Masks are cached by filter identity and parameters", "[filter]") {
+    Filter::FilterMask::clearCache();
+
+    Filter::Default def1 = Filter::Default();
+    Filter::Default def2 = Filter::Default();
+    Filter::Hue hue1 = Filter::Hue(120.0);
+    Filter::Hue hue2 = Filter::Hue(120.0);
+    Filter::Hue hue3 = Filter::Hue(120.5);
+
+    // Different instances with the same parameters share a mask
+    std::vector<Filter::Filter *> a = {&def1, &hue1};
+    std::vector<Filter::Filter *> b = {&def2, &hue2};
+    REQUIRE(Filter::FilterMask::get(a) == Filter::FilterMask::get(b));
+
+    // Different parameters don't
+    std::vector<Filter::Filter *> c = {&def1, &hue3};
+    REQUIRE(Filter::FilterMask::get(a) != Filter::FilterMask::get(c));
+
+    // Filters without an identifier are never cached
+    RedderThanBlue red = RedderThanBlue();
+    std::vector<Filter::Filter *> d = {&def1, &red};
+    REQUIRE(Filter::FilterMask::get(d) != Filter::FilterMask::get(d));
+
+    // Subclasses don't get their parent's mask, even with the same identifier
+    DefaultNotBlue notBlue = DefaultNotBlue();
+    std::vector<Filter::Filter *> e = {&def1};
+    std::vector<Filter::Filter *> f = {&notBlue};
+    REQUIRE(notBlue.identifier() == def1.identifier());
+    REQUIRE(Filter::FilterMask::get(e) != Filter::FilterMask::get(f));
+    REQUIRE(matchesFilters(*Filter::FilterMask::get(f), f));
+    REQUIRE(Filter::FilterMask::get(f) == Filter::FilterMask::get(f));
+}
+
+TEST_CASE("FilterMask: Masks can be made for each word width", "[filter]") {
+    Filter::Default def = Filter::Default();
+    Filter::Hue hue = Filter::Hue(30.0);
+    std::vector<Filter::Filter *> filters = {&def, &hue};
+
+    for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+        std::shared_ptr<const Filter::FilterMask> mask = Filter::FilterMask::get(filters, width);
+        INFO("Width: " << width);
+        REQUIRE(mask->getWordWidth() == width);
+        REQUIRE(matchesFilters(*mask, filters, width));
+    }
+
+    // Each width is cached separately
+    REQUIRE(Filter::FilterMask::get(filters, 4) != Filter::FilterMask::get(filters, 5));
+    REQUIRE(Filter::FilterMask::get(filters) == Filter::FilterMask::get(filters, 5));
+}
\ No newline at end of file
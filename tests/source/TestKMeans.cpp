@@ -0,0 +1,108 @@
+// This file tests the k-means refinement of swatches
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/ColourUtils.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/KMeans.hpp"
+#include "splash/Palette.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/Simd.hpp"
+#include "TestUtils.hpp"
+
+using namespace Splash;
+
+// Counts the bitmap into the workspace, refines the given swatches and clears the workspace
+static std::vector<Swatch> refine(const Bitmap & b, QuantizerWorkspace & ws, const std::vector<Swatch> & swatches, int iterations) {
+    std::vector<Filter::Filter *> filters;
+    Histogram::count(b, 1, ws);
+    std::shared_ptr<const Filter::FilterMask> mask = Filter::FilterMask::get(filters, ws.getWordWidth());
+    Histogram::filter(ws, *mask);
+    std::vector<Swatch> refined = KMeans::refine(ws, swatches, *mask, iterations, 0);
+    Histogram::clear(ws);
+    return refined;
+}
+
+TEST_CASE("KMeans: The LAB table matches the conversion of each bin", "[kmeans]") {
+    for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+        const std::vector<float> & table = KMeans::labTable(width);
+        REQUIRE(table.size() == Histogram::size(width) * 4);
+
+        size_t bins[3] = {0, Histogram::size(width)/3, Histogram::size(width) - 1};
+        for (size_t i = 0; i < 3; i++) {
+            Colour c = Histogram::colour(bins[i], width);
+            ColourUtils::LAB lab = ColourUtils::colourToLAB(c);
+            REQUIRE(table[bins[i] * 4] == Approx(lab.l));
+            REQUIRE(table[bins[i] * 4 + 1] == Approx(lab.a));
+            REQUIRE(table[bins[i] * 4 + 2] == Approx(lab.b));
+        }
+    }
+}
+
+TEST_CASE("KMeans: Poorly placed swatches are moved to the colours", "[kmeans]") {
+    Bitmap b = Bitmap(8, 8);
+    Colour red = Colour(255, 248, 0, 0);
+    Colour blue = Colour(255, 0, 0, 248);
+    for (size_t y = 0; y < 8; y++) {
+        for (size_t x = 0; x < 8; x++) {
+            b.setPixel(y < 4 ? red : blue, x, y);
+        }
+    }
+
+    // Both start out red
+    std::vector<Swatch> seeds = {Swatch(red, 1), Swatch(Colour(255, 160, 0, 40), 1)};
+    QuantizerWorkspace ws;
+
+    SECTION("Without iterations") {
+        REQUIRE(refine(b, ws, seeds, 0) == seeds);
+    }
+
+    SECTION("With iterations") {
+        std::vector<Swatch> swatches = refine(b, ws, seeds, 8);
+        REQUIRE(swatches.size() == 2);
+        REQUIRE(swatches[0].getColour().raw() == red.raw());
+        REQUIRE(swatches[0].getPopulation() == 32);
+        REQUIRE(swatches[1].getColour().raw() == blue.raw());
+        REQUIRE(swatches[1].getPopulation() == 32);
+    }
+}
+
+TEST_CASE("KMeans: Every colour is kept and each instruction set gives identical results", "[kmeans]") {
+    Bitmap b = createTestBitmap(160, 120, 4);
+    std::vector<Filter::Filter *> filters;
+    ColourCutQuantizer q = ColourCutQuantizer(b, 11, filters);
+    QuantizerWorkspace ws;
+
+    Simd::ISA original = Simd::getISA();
+    Simd::setISA(Simd::ISA::Scalar);
+    std::vector<Swatch> expected = refine(b, ws, q.getQuantizedColours(), 10);
+    REQUIRE(!expected.empty());
+    REQUIRE(expected.size() <= 11);
+    int64_t population = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        population += expected[i].getPopulation();
+    }
+    REQUIRE(population == 160 * 120);
+
+    Simd::ISA isas[3] = {Simd::ISA::SSE2, Simd::ISA::AVX2, Simd::ISA::NEON};
+    for (size_t i = 0; i < 3; i++) {
+        if (!Simd::setISA(isas[i])) {
+            continue;
+        }
+
+        INFO(Simd::toString(isas[i]));
+        REQUIRE(refine(b, ws, q.getQuantizedColours(), 10) == expected);
+    }
+    Simd::setISA(original);
+}
+
+TEST_CASE("KMeans: Refinement can be enabled when building a Palette", "[kmeans]") {
+    Bitmap b = createTestBitmap(160, 120, 5);
+    QuantizerWorkspace ws;
+    Palette p = Palette::from(b).clearFilters().resizeBitmapArea(0).setWorkspace(&ws).setMaximumColourCount(8).setRefinement(6, 1000).generate();
+
+    std::vector<Filter::Filter *> filters;
+    ColourCutQuantizer q = ColourCutQuantizer(b, 8, filters);
+    REQUIRE(p.getSwatches() == refine(b, ws, q.getQuantizedColours(), 6));
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+// This file tests the OctreeQuantizer class
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/filter/Default.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/OctreeQuantizer.hpp"
+#include "splash/Palette.hpp"
+#include "TestUtils.hpp"
+
+using namespace Splash;
+
+// Returns the total population of the swatches
+static int64_t totalPopulation(const std::vector<Swatch> & swatches) {
+    int64_t population = 0;
+    for (size_t i = 0; i < swatches.size(); i++) {
+        population += swatches[i].getPopulation();
+    }
+    return population;
+}
+
+TEST_CASE("OctreeQuantizer: Colours are used as is when there are fewer than requested", "[quantizer]") {
+    Bitmap b = Bitmap(4, 4);
+    Colour red = Colour(255, 250, 3, 1);
+    Colour blue = Colour(255, 2, 9, 251);
+    for (size_t x = 0; x < 4; x++) {
+        b.setPixel(red, x, 0);
+        b.setPixel(blue, x, 1);
+    }
+
+    std::vector<Filter::Filter *> filters;
+    OctreeQuantizer q = OctreeQuantizer(16, filters);
+    q.add(b);
+    std::vector<Swatch> swatches = q.getQuantizedColours();
+    REQUIRE(swatches.size() == 3);
+
+    // Stored in order of colour (blue, red, white)
+    REQUIRE(swatches[0].getColour().raw() == blue.raw());
+    REQUIRE(swatches[0].getPopulation() == 4);
+    REQUIRE(swatches[1].getColour().raw() == red.raw());
+    REQUIRE(swatches[1].getPopulation() == 4);
+    REQUIRE(swatches[2].getPopulation() == 8);
+}
+
+TEST_CASE("OctreeQuantizer: The node budget is never exceeded", "[quantizer]") {
+    Bitmap b = createTestBitmap(320, 240, 1);
+    std::vector<Filter::Filter *> filters;
+    const size_t budgets[3] = {64, 300, 4096};
+
+    for (size_t i = 0; i < 3; i++) {
+        INFO("Budget: " << budgets[i]);
+        OctreeQuantizer q = OctreeQuantizer(12, filters, budgets[i]);
+        bool withinBudget = true;
+        for (size_t y = 0; y < b.getHeight(); y++) {
+            q.add(BitmapView(b).crop(0, y, b.getWidth(), 1));
+            withinBudget = withinBudget && (q.getNodeCount() <= budgets[i]);
+        }
+        REQUIRE(withinBudget);
+
+        std::vector<Swatch> swatches = q.getQuantizedColours();
+        REQUIRE(!swatches.empty());
+        REQUIRE(swatches.size() <= 12);
+        REQUIRE(totalPopulation(swatches) == 320 * 240);
+    }
+}
+
+TEST_CASE("OctreeQuantizer: Adding rows gives the same result as the whole bitmap", "[quantizer]") {
+    Bitmap b = createTestBitmap(200, 150, 2);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+
+    OctreeQuantizer whole = OctreeQuantizer(16, filters, 512);
+    whole.add(b);
+
+    OctreeQuantizer rows = OctreeQuantizer(16, filters, 512);
+    for (size_t y = 0; y < b.getHeight(); y++) {
+        rows.add(BitmapView(b).crop(0, y, b.getWidth(), 1));
+    }
+
+    std::vector<Swatch> swatches = rows.getQuantizedColours();
+    REQUIRE(swatches == whole.getQuantizedColours());
+
+    // Only colours the filters allow are returned
+    for (size_t i = 0; i < swatches.size(); i++) {
+        Colour c = swatches[i].getColour();
+        REQUIRE(filters[0]->isAllowed(c));
+    }
+
+    delete filters[0];
+}
+
+TEST_CASE("OctreeQuantizer: Can be selected when building a Palette", "[quantizer]") {
+    Bitmap b = createTestBitmap(150, 100, 3);
+    Palette p = Palette::from(b).clearFilters().resizeBitmapArea(0).setQuantizer("Octree").generate();
+    std::vector<Swatch> swatches = p.getSwatches();
+    REQUIRE(!swatches.empty());
+    REQUIRE(swatches.size() <= 16);
+    REQUIRE(totalPopulation(swatches) == 150 * 100);
+}
\ No newline at end of file
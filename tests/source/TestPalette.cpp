@@ -0,0 +1,178 @@
+// This file tests the selection of swatches for targets in the Palette class
+#include "catch.hpp"
+#include "splash/Palette.hpp"
+#include "splash/Simd.hpp"
+#include "splash/target/DarkMuted.hpp"
+#include "splash/target/DarkVibrant.hpp"
+#include "splash/target/LightMuted.hpp"
+#include "splash/target/LightVibrant.hpp"
+#include "splash/target/Muted.hpp"
+#include "splash/target/Vibrant.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <set>
+
+using namespace Splash;
+
+// Returns the swatch chosen for each target by scoring each swatch one at a time,
+// as Android does (used to check the table based scoring)
+static std::vector<Swatch> referenceSelection(const std::vector<Swatch> & swatches, const std::vector<Target::Target> & targets) {
+    int64_t maxPop = 0;
+    for (const Swatch & swatch : swatches) {
+        maxPop = std::max(maxPop, swatch.getPopulation());
+    }
+    if (maxPop == 0) {
+        maxPop = 1;
+    }
+
+    std::set<int> used;
+    std::vector<Swatch> selected;
+    for (Target::Target target : targets) {
+        target.normalizeWeights();
+        float maxScore = 0;
+        Swatch maxSwatch = Swatch();
+        for (const Swatch & swatch : swatches) {
+            HSL hsl = swatch.getColour().hsl();
+            if (used.count(swatch.getColour().raw()) > 0 || hsl.s < target.getMinimumSaturation() || hsl.s > target.getMaximumSaturation() || hsl.l < target.getMinimumLightness() || hsl.l > target.getMaximumLightness()) {
+                continue;
+            }
+
+            float sScore = 0;
+            float lScore = 0;
+            float popScore = 0;
+            if (target.getSaturationWeight() > 0) {
+                sScore = target.getSaturationWeight() * (1.0f - std::abs(hsl.s - target.getTargetSaturation()));
+            }
+            if (target.getLightnessWeight() > 0) {
+                lScore = target.getLightnessWeight() * (1.0f - std::abs(hsl.l - target.getTargetLightness()));
+            }
+            if (target.getPopulationWeight() > 0) {
+                popScore = target.getPopulationWeight() * (swatch.getPopulation() / (float)maxPop);
+            }
+            float score = sScore + lScore + popScore;
+            if (!maxSwatch.isValid() || score > maxScore) {
+                maxSwatch = swatch;
+                maxScore = score;
+            }
+        }
+
+        if (maxSwatch.isValid() && target.isExclusive()) {
+            used.insert(maxSwatch.getColour().raw());
+        }
+        selected.push_back(maxSwatch);
+    }
+    return selected;
+}
+
+// Returns a random float between the given values
+static float randomFloat(float min, float max) {
+    return min + (max - min) * (std::rand() / (float)RAND_MAX);
+}
+
+TEST_CASE("Palette: Scoring matches the reference", "[palette]") {
+    Simd::ISA original = Simd::getISA();
+    std::srand(1);
+    for (size_t run = 0; run < 50; run++) {
+        // Random swatches, including some repeated colours
+        std::vector<Swatch> swatches;
+        size_t count = 1 + std::rand() % 40;
+        for (size_t i = 0; i < count; i++) {
+            Colour c = Colour(std::rand() % 256, std::rand() % 256, std::rand() % 256, 255);
+            if (i > 0 && std::rand() % 8 == 0) {
+                c = swatches[std::rand() % i].getColour();
+            }
+            swatches.push_back(Swatch(c, 1 + std::rand() % 1000));
+        }
+
+        // The default targets followed by random ones
+        Palette::Builder builder = Palette::Builder(swatches);
+        std::vector<Target::Target> targets = {Target::LIGHT_VIBRANT, Target::VIBRANT, Target::DARK_VIBRANT, Target::LIGHT_MUTED, Target::MUTED, Target::DARK_MUTED};
+        for (const Target::Target & target : targets) {
+            builder.addTarget(target);
+        }
+        for (size_t i = 0; i < 24; i++) {
+            float minS = randomFloat(0, 0.5f);
+            float minL = randomFloat(0, 0.5f);
+            Target::Target target = Target::Target::Builder().setMinimumSaturation(minS).setTargetSaturation(randomFloat(minS, 1)).setMaximumSaturation(randomFloat(minS, 1)).setSaturationWeight(randomFloat(0, 1)).setMinimumLightness(minL).setTargetLightness(randomFloat(minL, 1)).setMaximumLightness(randomFloat(minL, 1)).setLightnessWeight(randomFloat(0, 1)).setPopulationWeight(randomFloat(0, 1)).setExclusive(std::rand() % 2 == 0).build();
+            targets.push_back(target);
+            builder.addTarget(target);
+        }
+        std::vector<Swatch> expected = referenceSelection(swatches, targets);
+
+        // Each instruction set picks the same swatches
+        Simd::ISA isas[4] = {Simd::ISA::Scalar, Simd::ISA::SSE2, Simd::ISA::AVX2, Simd::ISA::NEON};
+        for (size_t j = 0; j < 4; j++) {
+            if (!Simd::setISA(isas[j])) {
+                continue;
+            }
+
+            // Handles are given out in the order targets are added
+            Palette palette = builder.generate();
+            for (size_t i = 0; i < targets.size(); i++) {
+                INFO(Simd::toString(isas[j]) << ", run: " << run << ", target: " << i);
+                Swatch swatch = palette.getSwatchForTarget(targets[i]);
+                REQUIRE(swatch.isValid() == expected[i].isValid());
+                REQUIRE(palette.getSwatchForTarget(i).isValid() == expected[i].isValid());
+                if (expected[i].isValid()) {
+                    REQUIRE(swatch == expected[i]);
+                    REQUIRE(palette.getSwatchForTarget(i) == expected[i]);
+                }
+            }
+        }
+    }
+    Simd::setISA(original);
+}
+
+TEST_CASE("Palette: Retrieving swatches for targets", "[palette]") {
+    std::vector<Swatch> swatches = {Swatch(Colour(230, 40, 40, 255), 100), Swatch(Colour(40, 40, 120, 255), 50), Swatch(Colour(200, 230, 200, 255), 20)};
+    Target::TargetSet set;
+    Target::Target custom = Target::Target::Builder().setMinimumLightness(0).setMaximumLightness(1).setMinimumSaturation(0).setMaximumSaturation(1).setPopulationWeight(3).setExclusive(false).build();
+    int handle = set.add(custom);
+    set.add(Target::VIBRANT);
+    Palette palette = Palette::Builder(swatches).setTargets(set).generate();
+
+    // Unnormalized weights are normalized for scoring, but the target is found as it was given
+    REQUIRE(palette.getSwatchForTarget(custom) == swatches[0]);
+    REQUIRE(palette.getSwatchForTarget(handle) == swatches[0]);
+    REQUIRE(palette.getSwatchForTarget(set.find(Target::VIBRANT)) == palette.getVibrantSwatch());
+
+    // Targets and handles which aren't in the palette give invalid swatches
+    Target::Target missing = Target::Target::Builder().setTargetLightness(0.1f).build();
+    REQUIRE_FALSE(palette.getSwatchForTarget(missing).isValid());
+    REQUIRE_FALSE(palette.getSwatchForTarget(-1).isValid());
+    REQUIRE_FALSE(palette.getSwatchForTarget(static_cast<int>(set.size())).isValid());
+    REQUIRE(palette.getColourForTarget(-1, Colour(1, 2, 3, 255)).raw() == Colour(1, 2, 3, 255).raw());
+    REQUIRE(palette.getTargets() == set.getTargets());
+}
+
+TEST_CASE("Palette: Palettes are values", "[palette]") {
+    std::vector<Swatch> swatches = {Swatch(Colour(230, 40, 40, 255), 100), Swatch(Colour(40, 40, 120, 255), 50), Swatch(Colour(200, 230, 200, 255), 20)};
+    Palette::Builder builder = Palette::Builder(swatches);
+    builder.addTarget(Target::VIBRANT);
+
+    // An empty palette gives invalid swatches
+    Palette palette;
+    REQUIRE(palette.getSwatches().empty());
+    REQUIRE_FALSE(palette.getDominantSwatch().isValid());
+    REQUIRE_FALSE(palette.getVibrantSwatch().isValid());
+
+    // Generating into a palette gives the same result as returning one
+    builder.generate(palette);
+    Palette expected = builder.generate();
+    REQUIRE(palette.getSwatches() == expected.getSwatches());
+    REQUIRE(palette.getVibrantSwatch() == expected.getVibrantSwatch());
+    REQUIRE(palette.getDominantSwatch() == swatches[0]);
+
+    // Copies don't change when the original is generated into again
+    Palette copy = palette;
+    Palette::Builder(std::vector<Swatch>{swatches[2]}).generate(palette);
+    REQUIRE(palette.getSwatches().size() == 1);
+    REQUIRE_FALSE(palette.getVibrantSwatch().isValid());
+    REQUIRE(copy.getSwatches() == expected.getSwatches());
+    REQUIRE(copy.getVibrantSwatch() == expected.getVibrantSwatch());
+
+    // Generating into it again with more swatches matches a new palette
+    builder.generate(palette);
+    REQUIRE(palette.getSwatches() == expected.getSwatches());
+    REQUIRE(palette.getVibrantSwatch() == expected.getVibrantSwatch());
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+// This file tests the Quantizer interface and registry
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/Palette.hpp"
+#include "splash/Quantizer.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "TestUtils.hpp"
+#include <algorithm>
+
+using namespace Splash;
+
+// Quantizer which only returns the most common colour, and records what it was given
+class MostCommon : public Quantizer {
+    public:
+        int calls = 0;
+        int maxColours = 0;
+        bool sawColours = true;
+
+        std::vector<Swatch> quantize(QuantizerWorkspace & ws, int max, const std::shared_ptr<const Filter::FilterMask> & mask, size_t) {
+            this->calls++;
+            this->maxColours = max;
+
+            // Every listed colour should have been counted and allowed by the mask
+            uint32_t best = 0;
+            for (size_t i = 0; i < ws.colours.size(); i++) {
+                uint32_t c = ws.colours[i];
+                if (ws.histogram[c] <= 0 || !mask->isAllowed(c)) {
+                    this->sawColours = false;
+                }
+                if (i == 0 || ws.histogram[c] > ws.histogram[best]) {
+                    best = c;
+                }
+            }
+
+            std::vector<Swatch> swatches;
+            if (!ws.colours.empty()) {
+                swatches.push_back(Swatch(Histogram::colour(best, ws.getWordWidth()), ws.histogram[best]));
+            }
+            return swatches;
+        }
+};
+
+TEST_CASE("Quantizer: Built in quantizers are registered", "[quantizer]") {
+    std::vector<std::string> names = Quantizer::names();
+    REQUIRE(std::find(names.begin(), names.end(), "ColourCut") != names.end());
+    REQUIRE(std::find(names.begin(), names.end(), "Wu") != names.end());
+    REQUIRE(Quantizer::get("ColourCut") != nullptr);
+    REQUIRE(Quantizer::get("Wu") != nullptr);
+    REQUIRE(Quantizer::get("NotAQuantizer") == nullptr);
+}
+
+TEST_CASE("Quantizer: Unknown names are ignored by the Builder", "[quantizer]") {
+    Bitmap b = createTestBitmap(120, 80, 1);
+    Palette expected = Palette::from(b).generate();
+    Palette p = Palette::from(b).setQuantizer("NotAQuantizer").generate();
+    REQUIRE(p.getSwatches() == expected.getSwatches());
+
+    // ColourCut is used by default
+    std::vector<Filter::Filter *> filters;
+    ColourCutQuantizer q = ColourCutQuantizer(b, 16, filters);
+    p = Palette::from(b).clearFilters().setQuantizer("ColourCut").generate();
+    REQUIRE(p.getSwatches() == q.getQuantizedColours());
+}
+
+TEST_CASE("Quantizer: Custom quantizers can be used", "[quantizer]") {
+    Bitmap b = createTestBitmap(120, 80, 2);
+    std::shared_ptr<MostCommon> engine = std::make_shared<MostCommon>();
+    QuantizerWorkspace ws;
+
+    SECTION("By pointer") {
+        Palette p = Palette::from(b).setQuantizer(engine).setWorkspace(&ws).setMaximumColourCount(12).generate();
+        REQUIRE(engine->calls == 1);
+        REQUIRE(engine->maxColours == 12);
+        REQUIRE(engine->sawColours);
+        REQUIRE(p.getSwatches().size() == 1);
+    }
+
+    SECTION("By name") {
+        Quantizer::add("MostCommon", engine);
+        REQUIRE(Quantizer::get("MostCommon") == engine);
+        Palette p = Palette::from(b).setQuantizer("MostCommon").setWorkspace(&ws).generate();
+        REQUIRE(engine->calls == 1);
+        REQUIRE(engine->sawColours);
+        REQUIRE(p.getSwatches().size() == 1);
+    }
+
+    // The workspace is cleared afterwards
+    bool cleared = ws.colours.empty();
+    for (size_t i = 0; i < ws.histogram.size(); i++) {
+        cleared = cleared && ws.histogram[i] == 0;
+    }
+    REQUIRE(cleared);
+}
\ No newline at end of file
@@ -0,0 +1,270 @@
+// This file tests the QuantizerWorkspace class
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/filter/Default.hpp"
+#include "splash/filter/FilterMask.hpp"
+#include "splash/Histogram.hpp"
+#include "splash/Palette.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/WuQuantizer.hpp"
+#include "TestUtils.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace Splash;
+
+// Number of allocations (and bytes allocated) by operator new in the test executable,
+// used to check that generating palettes with a workspace reuses its memory
+static std::atomic<size_t> allocations(0);
+static std::atomic<size_t> allocatedBytes(0);
+
+void * operator new(size_t size) {
+    allocations++;
+    allocatedBytes += size;
+    void * p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void * p) noexcept {
+    std::free(p);
+}
+
+// Returns whether the workspace's histogram has been left cleared
+static bool isCleared(const QuantizerWorkspace & ws) {
+    for (size_t i = 0; i < ws.histogram.size(); i++) {
+        if (ws.histogram[i] != 0 || ws.compact[i] != 0) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < ws.occupancy.size(); i++) {
+        if (ws.occupancy[i] != 0) {
+            return false;
+        }
+    }
+    return ws.colours.empty();
+}
+
+TEST_CASE("QuantizerWorkspace: Histogram is cleared after quantizing", "[workspace]") {
+    Bitmap b = createTestBitmap(200, 150, 5);
+    std::vector<Filter::Filter *> filters;
+    Filter::Default def;
+    filters.push_back(&def);
+    QuantizerWorkspace ws;
+
+    SECTION("ColourCutQuantizer") {
+        ColourCutQuantizer q = ColourCutQuantizer(b, 16, filters, 1, &ws);
+        REQUIRE(!q.getQuantizedColours().empty());
+        REQUIRE(isCleared(ws));
+
+        // Also when there are fewer colours than requested
+        ColourCutQuantizer all = ColourCutQuantizer(BitmapView(b).crop(0, 0, 2, 2), 16, filters, 1, &ws);
+        REQUIRE(isCleared(ws));
+    }
+
+    SECTION("WuQuantizer") {
+        WuQuantizer q = WuQuantizer(b, 16, filters, 1, &ws);
+        REQUIRE(!q.getQuantizedColours().empty());
+        REQUIRE(isCleared(ws));
+
+        WuQuantizer all = WuQuantizer(BitmapView(b).crop(0, 0, 2, 2), 16, filters, 1, &ws);
+        REQUIRE(isCleared(ws));
+    }
+
+    SECTION("Scaled and threaded counting") {
+        ColourCutQuantizer q = ColourCutQuantizer(b, 100, 75, 16, filters, 4, &ws);
+        REQUIRE(isCleared(ws));
+        WuQuantizer w = WuQuantizer(b, 100, 75, 16, filters, 4, &ws);
+        REQUIRE(isCleared(ws));
+    }
+}
+
+TEST_CASE("QuantizerWorkspace: Reusing a workspace gives the same result", "[workspace]") {
+    Bitmap b1 = createTestBitmap(160, 120, 6);
+    Bitmap b2 = createTestBitmap(90, 200, 7);
+    std::vector<Filter::Filter *> filters;
+    QuantizerWorkspace ws;
+
+    // Results from fresh workspaces
+    QuantizerWorkspace fresh1;
+    QuantizerWorkspace fresh2;
+    std::vector<Swatch> expected1 = ColourCutQuantizer(b1, 24, filters, 1, &fresh1).getQuantizedColours();
+    std::vector<Swatch> expected2 = WuQuantizer(b2, 24, filters, 1, &fresh2).getQuantizedColours();
+
+    // Alternate between quantizers and images using the same workspace
+    for (size_t i = 0; i < 3; i++) {
+        REQUIRE(sameSwatches(ColourCutQuantizer(b1, 24, filters, 1, &ws).getQuantizedColours(), expected1));
+        REQUIRE(sameSwatches(WuQuantizer(b2, 24, filters, 1, &ws).getQuantizedColours(), expected2));
+
+        // The calling thread's workspace is used by default
+        REQUIRE(sameSwatches(ColourCutQuantizer(b1, 24, filters).getQuantizedColours(), expected1));
+        REQUIRE(sameSwatches(WuQuantizer(b2, 24, filters).getQuantizedColours(), expected2));
+    }
+    REQUIRE(isCleared(QuantizerWorkspace::local()));
+}
+
+TEST_CASE("QuantizerWorkspace: Can be passed to a Palette::Builder", "[workspace]") {
+    Bitmap b = createTestBitmap(300, 300, 8);
+    QuantizerWorkspace ws;
+
+    Palette expected = Palette::from(b).generate();
+    for (size_t i = 0; i < 2; i++) {
+        Palette p = Palette::from(b).setWorkspace(&ws).generate();
+        REQUIRE(sameSwatches(p.getSwatches(), expected.getSwatches()));
+        REQUIRE(isCleared(ws));
+    }
+}
+
+TEST_CASE("QuantizerWorkspace: Generating again allocates little more than the swatches", "[workspace]") {
+    Bitmap b = createTestBitmap(300, 300, 10);
+
+    // Both while scaling (the default) and when counting every pixel
+    const int areas[2] = {-1, 0};
+    for (size_t i = 0; i < 2; i++) {
+        QuantizerWorkspace ws;
+        Palette::Builder builder = Palette::from(b);
+        builder.setWorkspace(&ws);
+        if (areas[i] >= 0) {
+            builder.resizeBitmapArea(areas[i]);
+        }
+
+        // The first run sizes the workspace and palette, and caches the filters' mask
+        Palette palette;
+        builder.generate(palette);
+        size_t count = allocations;
+        size_t bytes = allocatedBytes;
+        builder.generate(palette);
+        count = allocations - count;
+        bytes = allocatedBytes - bytes;
+
+        // Only the swatches and a few small vectors are allocated (a histogram alone is 128 KB)
+        INFO("Area: " << areas[i] << ", allocations: " << count << ", bytes: " << bytes);
+        REQUIRE(count <= 24);
+        REQUIRE(bytes <= 4096);
+        REQUIRE(isCleared(ws));
+    }
+}
+
+TEST_CASE("QuantizerWorkspace: Small views are counted with 16-bit bins", "[workspace]") {
+    std::vector<Filter::Filter *> filters;
+    std::shared_ptr<const Filter::FilterMask> mask = Filter::FilterMask::get(filters);
+    QuantizerWorkspace ws;
+
+    SECTION("Counts match counting each pixel") {
+        Bitmap b = createTestBitmap(250, 262, 9);
+        REQUIRE(b.getWidth() * b.getHeight() <= Histogram::MAX_COMPACT_PIXELS);
+
+        std::vector<int64_t> expected(Histogram::SIZE, 0);
+        for (size_t y = 0; y < b.getHeight(); y++) {
+            for (size_t x = 0; x < b.getWidth(); x++) {
+                expected[Histogram::quantize(b.getPixel(x, y))]++;
+            }
+        }
+
+        Histogram::count(b, 1, ws);
+        REQUIRE(ws.histogram == expected);
+
+        // Each non-zero bin is marked, and the 16-bit bins are left zeroed
+        bool marked = true;
+        for (size_t i = 0; i < Histogram::SIZE; i++) {
+            bool occupied = ((ws.occupancy[i / 64] >> (i % 64)) & 1);
+            marked = marked && ws.compact[i] == 0 && occupied == (expected[i] > 0);
+        }
+        REQUIRE(marked);
+
+        Histogram::filter(ws, *mask);
+        Histogram::clear(ws);
+        REQUIRE(isCleared(ws));
+    }
+
+    SECTION("A bin can hold every pixel") {
+        // Largest compact view, followed by the smallest which uses 64-bit bins
+        size_t counts[2] = {Histogram::MAX_COMPACT_PIXELS, Histogram::MAX_COMPACT_PIXELS + 1};
+        for (size_t i = 0; i < 2; i++) {
+            std::vector<Colour> pixels(counts[i], Colour(255, 120, 40, 200));
+            Histogram::count(BitmapView(pixels.data(), pixels.size(), 1, pixels.size()), 1, ws);
+
+            Histogram::filter(ws, *mask);
+            REQUIRE(ws.colours.size() == 1);
+            REQUIRE(ws.histogram[ws.colours[0]] == (int)counts[i]);
+            Histogram::clear(ws);
+            REQUIRE(isCleared(ws));
+        }
+    }
+}
+
+TEST_CASE("QuantizerWorkspace: Colours are counted using the word width", "[workspace]") {
+    Bitmap b = createTestBitmap(300, 250, 10);
+    std::vector<Filter::Filter *> filters;
+    QuantizerWorkspace ws;
+
+    for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+        ws.setWordWidth(width);
+        REQUIRE(ws.getWordWidth() == width);
+        REQUIRE(ws.histogram.size() == Histogram::size(width));
+
+        // Both the 16-bit and 64-bit bins are used
+        size_t heights[2] = {200, 250};
+        for (size_t i = 0; i < 2; i++) {
+            BitmapView view = BitmapView(b).crop(0, 0, 300, heights[i]);
+            std::vector<int64_t> expected(Histogram::size(width), 0);
+            for (size_t y = 0; y < view.getHeight(); y++) {
+                for (size_t x = 0; x < view.getWidth(); x++) {
+                    expected[Histogram::quantize(view.getPixel(x, y), width)]++;
+                }
+            }
+
+            INFO("Width: " << width << ", height: " << heights[i]);
+            Histogram::count(view, 2, ws);
+            REQUIRE(ws.histogram == expected);
+            Histogram::filter(ws, *Filter::FilterMask::get(filters, width));
+            Histogram::clear(ws);
+            REQUIRE(isCleared(ws));
+        }
+    }
+
+    // Widths outside of the supported range are clamped
+    ws.setWordWidth(8);
+    REQUIRE(ws.getWordWidth() == Histogram::MAX_WORD_WIDTH);
+    ws.setWordWidth(1);
+    REQUIRE(ws.getWordWidth() == Histogram::MIN_WORD_WIDTH);
+}
+
+TEST_CASE("QuantizerWorkspace: Bins hold counts past the range of an int", "[workspace]") {
+    // Counting this many pixels would take too long, so most of the counts are added to the bins directly
+    std::vector<Filter::Filter *> filters;
+    std::shared_ptr<const Filter::FilterMask> mask = Filter::FilterMask::get(filters);
+    QuantizerWorkspace ws;
+    Colour red = Colour(255, 200, 40, 40);
+    Colour blue = Colour(255, 40, 40, 200);
+    std::vector<Colour> pixels = {red, blue};
+    Histogram::count(BitmapView(pixels.data(), pixels.size(), 1, pixels.size()), 1, ws);
+
+    const int64_t reds = static_cast<int64_t>(1) << 32;
+    const int64_t blues = static_cast<int64_t>(1) << 31;
+    ws.histogram[Histogram::quantize(red)] += reds - 1;
+    ws.histogram[Histogram::quantize(blue)] += blues - 1;
+    Histogram::filter(ws, *mask);
+    REQUIRE(ws.histogram[Histogram::quantize(red)] == reds);
+
+    // Both colours have to be merged into one box, summing their populations
+    std::vector<Swatch> swatches;
+    SECTION("ColourCutQuantizer") {
+        swatches = ColourCutQuantizer(ws, 1, mask).getQuantizedColours();
+    }
+
+    SECTION("WuQuantizer") {
+        swatches = WuQuantizer(ws, 1, mask).getQuantizedColours();
+    }
+
+    REQUIRE(swatches.size() == 1);
+    REQUIRE(swatches[0].getPopulation() == reds + blues);
+    REQUIRE(swatches[0].getColour().r() > swatches[0].getColour().b());
+
+    Histogram::clear(ws);
+    REQUIRE(isCleared(ws));
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+// This file tests the SplitTree class
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/filter/Default.hpp"
+#include "splash/Palette.hpp"
+#include "splash/SplitTree.hpp"
+#include "TestUtils.hpp"
+
+using namespace Splash;
+
+TEST_CASE("SplitTree: Cutting the tree matches quantizing to each count", "[quantizer]") {
+    Bitmap b = createTestBitmap(240, 180, 1);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+    const int counts[8] = {1, 2, 3, 8, 16, 32, 64, 100};
+
+    for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+        // Built for 32 colours, so the last two counts split it further
+        SplitTree tree = SplitTree(b, 32, filters, 1, width);
+        for (size_t i = 0; i < 8; i++) {
+            INFO("Width: " << width << ", colours: " << counts[i]);
+            ColourCutQuantizer q = ColourCutQuantizer(b, counts[i], filters, 1, nullptr, width);
+            REQUIRE(tree.getQuantizedColours(counts[i]) == q.getQuantizedColours());
+        }
+
+        // Smaller counts still match once it has grown
+        ColourCutQuantizer q = ColourCutQuantizer(b, 16, filters, 1, nullptr, width);
+        REQUIRE(tree.getQuantizedColours(16) == q.getQuantizedColours());
+    }
+
+    delete filters[0];
+}
+
+TEST_CASE("SplitTree: Colours are used as is when there are fewer than requested", "[quantizer]") {
+    Bitmap b = Bitmap(4, 4);
+    Colour red = Colour(255, 248, 0, 0);
+    Colour blue = Colour(255, 0, 0, 248);
+    for (size_t x = 0; x < 4; x++) {
+        b.setPixel(red, x, 0);
+        b.setPixel(blue, x, 1);
+    }
+
+    std::vector<Filter::Filter *> filters;
+    SplitTree tree = SplitTree(b, 2, filters);
+    for (int count = 1; count <= 4; count++) {
+        INFO("Colours: " << count);
+        ColourCutQuantizer q = ColourCutQuantizer(b, count, filters);
+        REQUIRE(tree.getQuantizedColours(count) == q.getQuantizedColours());
+    }
+}
+
+TEST_CASE("SplitTree: Each split divides a node's population between its halves", "[quantizer]") {
+    Bitmap b = createTestBitmap(160, 120, 2);
+    std::vector<Filter::Filter *> filters;
+    SplitTree tree = SplitTree(b, 24, filters);
+
+    const std::vector<SplitTree::Node> & nodes = tree.getNodes();
+    const std::vector<int> & splits = tree.getSplits();
+    REQUIRE(splits.size() == 23);
+    REQUIRE(nodes.size() == 1 + splits.size() * 2);
+    REQUIRE(nodes[0].swatch.getPopulation() == 160 * 120);
+
+    bool divided = true;
+    for (size_t i = 0; i < splits.size(); i++) {
+        const SplitTree::Node & node = nodes[splits[i]];
+        divided = divided && (node.lower >= 0 && node.upper >= 0);
+        divided = divided && (nodes[node.lower].swatch.getPopulation() + nodes[node.upper].swatch.getPopulation() == node.swatch.getPopulation());
+    }
+    REQUIRE(divided);
+}
+
+TEST_CASE("SplitTree: Palettes for several counts match generating each separately", "[quantizer]") {
+    Bitmap b = createTestBitmap(200, 150, 3);
+    const std::vector<size_t> counts = {8, 32, 16};
+    const std::string quantizers[3] = {"ColourCut", "Wu", "Octree"};
+
+    for (size_t q = 0; q < 3; q++) {
+        INFO("Quantizer: " << quantizers[q]);
+        std::vector<Palette> palettes = Palette::from(b).setQuantizer(quantizers[q]).generate(counts);
+        REQUIRE(palettes.size() == counts.size());
+        for (size_t i = 0; i < counts.size(); i++) {
+            Palette p = Palette::from(b).setQuantizer(quantizers[q]).setMaximumColourCount(counts[i]).generate();
+            REQUIRE(palettes[i].getSwatches() == p.getSwatches());
+            REQUIRE(palettes[i].getVibrantSwatch() == p.getVibrantSwatch());
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+// This file tests the Target class
+#include "catch.hpp"
+#include "splash/target/DarkMuted.hpp"
+#include "splash/target/DarkVibrant.hpp"
+#include "splash/target/LightMuted.hpp"
+#include "splash/target/LightVibrant.hpp"
+#include "splash/target/Muted.hpp"
+#include "splash/target/Vibrant.hpp"
+#include <type_traits>
+
+using namespace Splash;
+
+// The default targets are constants and copying a target doesn't allocate
+constexpr Target::Target COPY = Target::LIGHT_MUTED;
+static_assert(std::is_trivially_copyable<Target::Target>::value, "Targets should be trivially copyable");
+
+TEST_CASE("Target: Default targets", "[target]") {
+    // Values match Android's
+    REQUIRE(Target::VIBRANT.getMinimumSaturation() == 0.35f);
+    REQUIRE(Target::VIBRANT.getTargetSaturation() == 1.0f);
+    REQUIRE(Target::VIBRANT.getMaximumSaturation() == 1.0f);
+    REQUIRE(Target::VIBRANT.getMinimumLightness() == 0.3f);
+    REQUIRE(Target::VIBRANT.getTargetLightness() == 0.5f);
+    REQUIRE(Target::VIBRANT.getMaximumLightness() == 0.7f);
+
+    REQUIRE(Target::LIGHT_VIBRANT.getMinimumLightness() == 0.55f);
+    REQUIRE(Target::LIGHT_VIBRANT.getTargetLightness() == 0.74f);
+    REQUIRE(Target::LIGHT_VIBRANT.getMaximumLightness() == 1.0f);
+
+    REQUIRE(Target::DARK_MUTED.getMinimumSaturation() == 0.0f);
+    REQUIRE(Target::DARK_MUTED.getTargetSaturation() == 0.3f);
+    REQUIRE(Target::DARK_MUTED.getMaximumSaturation() == 0.4f);
+    REQUIRE(Target::DARK_MUTED.getMinimumLightness() == 0.0f);
+    REQUIRE(Target::DARK_MUTED.getTargetLightness() == 0.26f);
+    REQUIRE(Target::DARK_MUTED.getMaximumLightness() == 0.45f);
+
+    const Target::Target targets[6] = {Target::VIBRANT, Target::LIGHT_VIBRANT, Target::DARK_VIBRANT, Target::MUTED, Target::LIGHT_MUTED, Target::DARK_MUTED};
+    for (size_t i = 0; i < 6; i++) {
+        REQUIRE(targets[i].getSaturationWeight() == 0.24f);
+        REQUIRE(targets[i].getLightnessWeight() == 0.52f);
+        REQUIRE(targets[i].getPopulationWeight() == 0.24f);
+        REQUIRE(targets[i].isExclusive());
+        for (size_t j = 0; j < 6; j++) {
+            REQUIRE((targets[i] == targets[j]) == (i == j));
+        }
+    }
+    REQUIRE(COPY == Target::LIGHT_MUTED);
+}
+
+TEST_CASE("Target: Builder", "[target]") {
+    // A default target accepts any colour
+    Target::Target target = Target::Target::Builder().build();
+    REQUIRE(target.getMinimumSaturation() == 0.0f);
+    REQUIRE(target.getMaximumLightness() == 1.0f);
+    REQUIRE(target == Target::Target());
+
+    // Building from an existing target doesn't modify it
+    Target::Target muted = Target::MUTED;
+    Target::Target changed = Target::Target::Builder(muted).setTargetLightness(0.6f).setExclusive(false).build();
+    REQUIRE(muted == Target::MUTED);
+    REQUIRE(changed.getTargetLightness() == 0.6f);
+    REQUIRE_FALSE(changed.isExclusive());
+    REQUIRE(changed.getMaximumSaturation() == Target::MUTED.getMaximumSaturation());
+
+    // Only positive weights are normalized
+    Target::Target weighted = Target::Target::Builder().setSaturationWeight(1).setLightnessWeight(3).setPopulationWeight(-2).build();
+    weighted.normalizeWeights();
+    REQUIRE(weighted.getSaturationWeight() == 0.25f);
+    REQUIRE(weighted.getLightnessWeight() == 0.75f);
+    REQUIRE(weighted.getPopulationWeight() == -2.0f);
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+// This file tests the TargetSet class
+#include "catch.hpp"
+#include "splash/Simd.hpp"
+#include "splash/target/DarkMuted.hpp"
+#include "splash/target/DarkVibrant.hpp"
+#include "splash/target/LightMuted.hpp"
+#include "splash/target/LightVibrant.hpp"
+#include "splash/target/Muted.hpp"
+#include "splash/target/TargetSet.hpp"
+#include "splash/target/Vibrant.hpp"
+
+using namespace Splash;
+
+TEST_CASE("TargetSet: Handles", "[target]") {
+    Target::TargetSet set = Target::TargetSet::defaults();
+    REQUIRE(set.size() == 6);
+    REQUIRE(set.find(Target::VIBRANT) == 0);
+    REQUIRE(set.find(Target::LIGHT_VIBRANT) == 1);
+    REQUIRE(set.find(Target::DARK_VIBRANT) == 2);
+    REQUIRE(set.find(Target::MUTED) == 3);
+    REQUIRE(set.find(Target::LIGHT_MUTED) == 4);
+    REQUIRE(set.find(Target::DARK_MUTED) == 5);
+
+    // Adding an equal target gives back its handle
+    REQUIRE(set.add(Target::MUTED) == 3);
+    REQUIRE(set.size() == 6);
+
+    Target::Target custom = Target::Target::Builder().setTargetLightness(0.1f).build();
+    REQUIRE(set.find(custom) == -1);
+    REQUIRE(set.add(custom) == 6);
+    REQUIRE(set.get(6) == custom);
+    REQUIRE(set.getTargets().size() == 7);
+
+    set.clear();
+    REQUIRE(set.size() == 0);
+    REQUIRE(set.find(Target::VIBRANT) == -1);
+}
+
+TEST_CASE("TargetSet: Default handles", "[target]") {
+    Target::TargetSet set = Target::TargetSet::defaults();
+    REQUIRE(set.getDefaultHandle(Target::Default::Vibrant) == 0);
+    REQUIRE(set.getDefaultHandle(Target::Default::LightVibrant) == 1);
+    REQUIRE(set.getDefaultHandle(Target::Default::DarkVibrant) == 2);
+    REQUIRE(set.getDefaultHandle(Target::Default::Muted) == 3);
+    REQUIRE(set.getDefaultHandle(Target::Default::LightMuted) == 4);
+    REQUIRE(set.getDefaultHandle(Target::Default::DarkMuted) == 5);
+
+    // Defaults are found wherever (and however many times) they're added
+    Target::TargetSet custom;
+    REQUIRE(custom.getDefaultHandle(Target::Default::Muted) == -1);
+    custom.add(Target::Target::Builder().setTargetLightness(0.1f).build());
+    custom.add(Target::MUTED);
+    custom.add(Target::MUTED);
+    REQUIRE(custom.getDefaultHandle(Target::Default::Muted) == 1);
+    REQUIRE(custom.getDefaultHandle(Target::Default::Vibrant) == -1);
+
+    custom.clear();
+    REQUIRE(custom.getDefaultHandle(Target::Default::Muted) == -1);
+}
+
+TEST_CASE("TargetSet: Weights are normalized when added", "[target]") {
+    Target::TargetSet set;
+    Target::Target target = Target::Target::Builder().setSaturationWeight(2).setLightnessWeight(6).setPopulationWeight(-1).setTargetSaturation(0.25f).setTargetLightness(0.75f).build();
+    REQUIRE(set.add(target) == 0);
+
+    // The target itself is kept as it was given
+    REQUIRE(set.get(0).getSaturationWeight() == 2);
+
+    const float * values = set.getScoringValues();
+    REQUIRE(values[0] == 0.25f);
+    REQUIRE(values[1] == 0.75f);
+    REQUIRE(values[2] == 0);
+    REQUIRE(values[3] == 0.25f);
+    REQUIRE(values[4] == 0.75f);
+    REQUIRE(values[5] == target.getMinimumSaturation());
+    REQUIRE(values[6] == target.getMaximumSaturation());
+    REQUIRE(values[7] == target.getMinimumLightness());
+    REQUIRE(values[8] == target.getMaximumLightness());
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+// This file tests the WorkerPool class
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/ColourCutQuantizer.hpp"
+#include "splash/QuantizerWorkspace.hpp"
+#include "splash/WorkerPool.hpp"
+#include "TestUtils.hpp"
+#include <functional>
+#include <thread>
+
+using namespace Splash;
+
+TEST_CASE("WorkerPool: Each part is run once", "[workspace]") {
+    WorkerPool pool;
+    const size_t parts[4] = {1, 4, 2, 6};
+    for (size_t i = 0; i < 4; i++) {
+        INFO("Parts: " << parts[i]);
+        std::vector<int> runs(parts[i], 0);
+        std::vector<std::thread::id> ids(parts[i]);
+        pool.run(parts[i], [&runs, &ids](size_t part) {
+            runs[part]++;
+            ids[part] = std::this_thread::get_id();
+        });
+
+        // The first part is run on the calling thread, and every other part on a different thread
+        REQUIRE(runs == std::vector<int>(parts[i], 1));
+        REQUIRE(ids[0] == std::this_thread::get_id());
+        for (size_t j = 1; j < parts[i]; j++) {
+            REQUIRE(ids[j] != ids[j - 1]);
+        }
+    }
+}
+
+TEST_CASE("WorkerPool: Threads are only started when more are needed", "[workspace]") {
+    WorkerPool pool;
+    std::function<void(size_t)> nothing = [](size_t) {};
+    pool.run(1, nothing);
+    REQUIRE(pool.size() == 0);
+    pool.run(4, nothing);
+    REQUIRE(pool.size() == 3);
+    pool.run(2, nothing);
+    pool.run(4, nothing);
+    REQUIRE(pool.size() == 3);
+    pool.run(5, nothing);
+    REQUIRE(pool.size() == 4);
+}
+
+TEST_CASE("WorkerPool: Quantizing again reuses the workspace's threads", "[workspace]") {
+    Bitmap b = createTestBitmap(640, 480, 4);
+    std::vector<Filter::Filter *> filters;
+    QuantizerWorkspace ws;
+
+    ColourCutQuantizer first = ColourCutQuantizer(b, 128, filters, 4, &ws);
+    REQUIRE(ws.workers.size() == 3);
+    ColourCutQuantizer second = ColourCutQuantizer(b, 128, filters, 4, &ws);
+    REQUIRE(ws.workers.size() == 3);
+    REQUIRE(sameSwatches(first.getQuantizedColours(), second.getQuantizedColours()));
+}
\ No newline at end of file
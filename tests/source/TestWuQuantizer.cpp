@@ -0,0 +1,106 @@
+// This file tests the WuQuantizer class
+#include "catch.hpp"
+#include "splash/Bitmap.hpp"
+#include "splash/filter/Default.hpp"
+#include "splash/Palette.hpp"
+#include "splash/WuQuantizer.hpp"
+#include "TestUtils.hpp"
+
+using namespace Splash;
+
+TEST_CASE("WuQuantizer: Colours are used as is when there are fewer than requested", "[quantizer]") {
+    Bitmap b = Bitmap(4, 4);
+    Colour red = Colour(255, 248, 0, 0);
+    Colour blue = Colour(255, 0, 0, 248);
+    for (size_t x = 0; x < 4; x++) {
+        b.setPixel(red, x, 0);
+        b.setPixel(blue, x, 1);
+    }
+
+    std::vector<Filter::Filter *> filters;
+    WuQuantizer q = WuQuantizer(b, 16, filters);
+    std::vector<Swatch> swatches = q.getQuantizedColours();
+    REQUIRE(swatches.size() == 3);
+
+    // Stored in histogram order (blue, red, white)
+    REQUIRE(swatches[0].getColour().raw() == blue.raw());
+    REQUIRE(swatches[0].getPopulation() == 4);
+    REQUIRE(swatches[1].getColour().raw() == red.raw());
+    REQUIRE(swatches[1].getPopulation() == 4);
+    REQUIRE(swatches[2].getPopulation() == 8);
+}
+
+TEST_CASE("WuQuantizer: Reduces the image to at most the requested number of colours", "[quantizer]") {
+    Bitmap b = createTestBitmap(320, 240, 4);
+    std::vector<Filter::Filter *> filters;
+
+    size_t counts[3] = {1, 16, 200};
+    for (size_t i = 0; i < 3; i++) {
+        WuQuantizer q = WuQuantizer(b, counts[i], filters);
+        std::vector<Swatch> swatches = q.getQuantizedColours();
+        REQUIRE(!swatches.empty());
+        REQUIRE(swatches.size() <= counts[i]);
+
+        // Without filters every pixel belongs to exactly one swatch
+        int population = 0;
+        for (size_t j = 0; j < swatches.size(); j++) {
+            population += swatches[j].getPopulation();
+        }
+        REQUIRE(population == 320 * 240);
+    }
+}
+
+TEST_CASE("WuQuantizer: Filtered colours are never returned", "[quantizer]") {
+    Bitmap b = createTestBitmap(200, 200, 5);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+
+    WuQuantizer q = WuQuantizer(b, 24, filters);
+    std::vector<Swatch> swatches = q.getQuantizedColours();
+    REQUIRE(!swatches.empty());
+    for (size_t i = 0; i < swatches.size(); i++) {
+        Colour c = swatches[i].getColour();
+        REQUIRE(filters[0]->isAllowed(c));
+    }
+
+    delete filters[0];
+}
+
+TEST_CASE("WuQuantizer: Can be selected when building a Palette", "[quantizer]") {
+    Bitmap b = createTestBitmap(150, 100, 6);
+    std::vector<Filter::Filter *> filters = {new Filter::Default()};
+    WuQuantizer q = WuQuantizer(b, 16, filters);
+    std::vector<Swatch> expected = q.getQuantizedColours();
+    delete filters[0];
+
+    Palette p = Palette::from(b).resizeBitmapArea(0).setQuantizer("Wu").generate();
+    std::vector<Swatch> swatches = p.getSwatches();
+    REQUIRE(swatches.size() == expected.size());
+    for (size_t i = 0; i < swatches.size(); i++) {
+        REQUIRE(swatches[i] == expected[i]);
+    }
+}
+
+TEST_CASE("WuQuantizer: Colours can be quantized with each word width", "[quantizer]") {
+    Bitmap b = createTestBitmap(320, 240, 7);
+    std::vector<Filter::Filter *> filters;
+
+    for (int width = Histogram::MIN_WORD_WIDTH; width <= Histogram::MAX_WORD_WIDTH; width++) {
+        INFO("Width: " << width);
+        WuQuantizer q = WuQuantizer(b, 16, filters, 1, nullptr, width);
+        std::vector<Swatch> swatches = q.getQuantizedColours();
+        REQUIRE(!swatches.empty());
+        REQUIRE(swatches.size() <= 16);
+
+        // Every pixel belongs to exactly one swatch
+        int64_t population = 0;
+        for (size_t i = 0; i < swatches.size(); i++) {
+            population += swatches[i].getPopulation();
+        }
+        REQUIRE(population == 320 * 240);
+    }
+
+    // Setting the width on a Palette gives the same result
+    WuQuantizer q = WuQuantizer(b, 16, filters, 1, nullptr, 6);
+    Palette p = Palette::from(b).clearFilters().resizeBitmapArea(0).setQuantizer("Wu").setBitsPerComponent(6).generate();
+    REQUIRE(p.getSwatches() == q.getQuantizedColours());
+}
\ No newline at end of file